@@ -0,0 +1,60 @@
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "AgentSession.h"
+#include "StateStream.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Construct a session with a world of the given size. Nothing is in it until
+	the first episode is started by Reset. */
+AgentSession::AgentSession(int w, int h)
+	: HeadlessSession(w, h),
+	  mEpisodeSeed(0)
+{
+}
+
+/** Destructor. */
+AgentSession::~AgentSession(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Start a new episode in a fresh world seeded with seed, so that an episode
+	depends only on its seed and the actions taken, never on earlier episodes. */
+void AgentSession::Reset(uint seed)
+{
+	int w = mGameWorld->GetWidth();
+	int h = mGameWorld->GetHeight();
+	delete mGameWorld;
+	mGameWorld = new GameWorld();
+	mGameWorld->SetWidth(w);
+	mGameWorld->SetHeight(h);
+	mGameWorld->SetRandomSeed(seed);
+	mEpisodeSeed = seed;
+
+	mTimerListeners.clear();
+	mNextTimerId = 0;
+	mElapsedTime = 0;
+	mFrameCount = 0;
+	// Kept states are of the last episode
+	mRewindRing.Clear();
+
+	StartEpisode();
+	Start();
+}
+
+/** Save the state of the session, including the seed the episode started from. */
+void AgentSession::SaveState(StateWriter& writer)
+{
+	HeadlessSession::SaveState(writer);
+	writer.Write(mEpisodeSeed);
+}
+
+/** Restore the state saved by SaveState. */
+bool AgentSession::RestoreState(StateReader& reader)
+{
+	if (!HeadlessSession::RestoreState(reader)) return false;
+	reader.Read(mEpisodeSeed);
+	return !reader.HasFailed();
+}
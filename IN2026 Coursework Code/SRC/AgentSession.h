@@ -0,0 +1,34 @@
+#ifndef __AGENTSESSION_H__
+#define __AGENTSESSION_H__
+
+#include "GameUtil.h"
+#include "HeadlessSession.h"
+
+class AgentSession : public HeadlessSession
+{
+public:
+	AgentSession(int w = 133, int h = 133);
+	virtual ~AgentSession(void);
+
+	void Reset(uint seed);
+
+	// Hold the controls given by the bits of action until the next action
+	virtual void Act(uint action) = 0;
+	// Write GetObservationSize() values describing the state of the episode
+	virtual void Observe(float* observation) = 0;
+	virtual uint GetObservationSize(void) = 0;
+	virtual bool IsEpisodeOver(void) = 0;
+
+	uint GetEpisodeSeed() { return mEpisodeSeed; }
+
+	virtual void SaveState(StateWriter& writer);
+	virtual bool RestoreState(StateReader& reader);
+
+protected:
+	// Populate the new world of an episode, whose generator has been seeded
+	virtual void StartEpisode(void) = 0;
+
+	uint mEpisodeSeed;
+};
+
+#endif
@@ -6,11 +6,12 @@ using namespace std;
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
-Animation::Animation(uint width, uint height, uint* frame_ids, uint num_frames)
-	: mWidth(width), mHeight(height), mFrameIDs(frame_ids), mNumFrames(num_frames)
+Animation::Animation(uint width, uint height, uint texture_id, float* frame_rects, uint num_frames)
+	: mWidth(width), mHeight(height), mTextureID(texture_id), mFrameRects(frame_rects), mNumFrames(num_frames)
 {
 }
 
 Animation::~Animation()
 {
+	delete[] mFrameRects;
 }
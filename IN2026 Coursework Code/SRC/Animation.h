@@ -6,16 +6,19 @@ class Image;
 class Animation
 {
 public:
-	Animation(uint width, uint height, uint* frame_ids, uint num_frames);
+	Animation(uint width, uint height, uint texture_id, float* frame_rects, uint num_frames);
 	~Animation();
 	uint GetWidth() { return mWidth; }
 	uint GetHeight() { return mHeight; }
-	uint GetFrameTextureID(uint n) const { return mFrameIDs[n]; }
+	uint GetTextureID() const { return mTextureID; }
+	const float* GetFrameRect(uint n) const { return &mFrameRects[4 * n]; }
 	uint GetNumFrames() const { return mNumFrames; }
 private:
 	uint mWidth;
 	uint mHeight;
-	uint* mFrameIDs;
+	// Texture holding every frame, and the u1, v1, u2, v2 texture coordinates of each frame in it
+	uint mTextureID;
+	float* mFrameRects;
 	uint mNumFrames;
 };
 
@@ -13,21 +13,27 @@ Animation* AnimationManager::CreateAnimationFromFile(const string& name, const u
 
 Animation* AnimationManager::CreateAnimationFromImage(const string& name, const uint frame_width, const uint frame_height, Image* image)
 {
+	// Keep the whole image as one texture so every frame renders from the same binding
+	Texture* texture = TextureManager::GetInstance().CreateTextureFromImage(name, image);
+	float width = (float)image->GetWidth();
+	float height = (float)image->GetHeight();
+	// Inset each frame by half a texel so linear filtering does not blend in its neighbours
+	float inset_u = 0.5f / width;
+	float inset_v = 0.5f / height;
+
 	uint num_frames = (image->GetWidth() / frame_width) * (image->GetHeight() / frame_height);
-	uint* texture_ids = new uint[num_frames];
+	float* frame_rects = new float[4 * num_frames];
 	uint current_frame = 0;
-	for (uint i = 0; i < image->GetWidth(); i += frame_width) {
-		for (uint j = 0; j < image->GetHeight(); j += frame_height) {
-			std::ostringstream frame_stream;
-			frame_stream << name << "-" << current_frame;
-			std::string frame_name = frame_stream.str();
-
-			Image* frame_image = ImageManager::GetInstance().CreateImageFromImage(frame_name, image, i, j, frame_width, frame_height);
-			Texture* frame_texture = TextureManager::GetInstance().CreateTextureFromImage(frame_name, frame_image);
-			texture_ids[current_frame++] = frame_texture->GetTextureID();
+	for (uint i = 0; i + frame_width <= image->GetWidth(); i += frame_width) {
+		for (uint j = 0; j + frame_height <= image->GetHeight(); j += frame_height) {
+			float* rect = &frame_rects[4 * current_frame++];
+			rect[0] = i / width + inset_u;
+			rect[1] = j / height + inset_v;
+			rect[2] = (i + frame_width) / width - inset_u;
+			rect[3] = (j + frame_height) / height - inset_v;
 		}
 	}
-	Animation* animation = new Animation(frame_width, frame_height, texture_ids, num_frames);
+	Animation* animation = new Animation(frame_width, frame_height, texture->GetTextureID(), frame_rects, num_frames);
 	mAnimationMap.insert(NamedAnimationMap::value_type(name, animation));
 	return animation;
 }
@@ -1,18 +1,24 @@
 #include <stdlib.h>
 #include "GameUtil.h"
 #include "Asteroid.h"
+#include "Random.h"
 #include "BoundingShape.h"
+#include "CollisionLayers.h"
 
-Asteroid::Asteroid(void) : GameObject("Asteroid")
+Asteroid::Asteroid(Random& random) : GameObject("Asteroid")
 {
-	mAngle = rand() % 360;
-	mRotation = 0; // rand() % 90;
-	mPosition.x = rand() / 2;
-	mPosition.y = rand() / 2;
+	mAngle = random.Next(360);
+	mRotation = 0; // random.Next(90);
+	// Draw from the range rand() has with the Windows CRT the game was written
+	// for, as a larger RAND_MAX puts asteroids millions of worlds away to wrap
+	mPosition.x = random.Next(32768) / 2;
+	mPosition.y = random.Next(32768) / 2;
 	mPosition.z = 0.0;
 	mVelocity.x = 10.0 * cos(DEG2RAD*mAngle);
 	mVelocity.y = 10.0 * sin(DEG2RAD*mAngle);
 	mVelocity.z = 0.0;
+	mCollisionLayer = COLLISION_LAYER_ASTEROID;
+	mCollisionMask = COLLISION_MASK_ALL & ~COLLISION_LAYER_ASTEROID;
 }
 
 Asteroid::~Asteroid(void)
@@ -27,7 +33,7 @@ bool Asteroid::CollisionTest(shared_ptr<GameObject> o)
 	return mBoundingShape->CollisionTest(o->GetBoundingShape());
 }
 
-void Asteroid::OnCollision(const GameObjectList& objects)
+void Asteroid::OnCollision(const GameObjectSpan& objects)
 {
 	mWorld->FlagForRemoval(GetThisPtr());
 }
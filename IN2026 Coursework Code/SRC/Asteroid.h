@@ -3,14 +3,16 @@
 
 #include "GameObject.h"
 
+class Random;
+
 class Asteroid : public GameObject
 {
 public:
-	Asteroid(void);
+	Asteroid(Random& random);
 	~Asteroid(void);
 
 	bool CollisionTest(shared_ptr<GameObject> o);
-	void OnCollision(const GameObjectList& objects);
+	void OnCollision(const GameObjectSpan& objects);
 };
 
 #endif
@@ -11,15 +11,22 @@
 #include "BoundingSphere.h"
 #include "GUILabel.h"
 #include "Explosion.h"
+#include "ObjectTypes.h"
 #include <algorithm>
+#include <ctime>
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
-/** Constructor. Takes arguments from command line, just in case. */
+/** Constructor. Takes arguments from command line: -record <file> records every
+	input to a file and -replay <file> plays a recorded game back. */
 Asteroids::Asteroids(int argc, char *argv[])
-	: GameSession(argc, argv)
+	: GameSession(argc, argv), mBulletPool(BULLET_POOL_CAPACITY), mReplayReported(false)
 {
 	mLevel = 0;
 	mAsteroidCount = 0;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (string(argv[i]) == "-record") mRecordFilename = argv[++i];
+		else if (string(argv[i]) == "-replay") mReplayFilename = argv[++i];
+	}
 }
 
 /** Destructor. */
@@ -38,12 +45,36 @@ void Asteroids::Start()
 	// Add this class as a listener of the game world
 	mGameWorld->AddListener(thisPtr.get());
 
+	// Simulate in fixed ticks so frame rate hitches do not change the physics
+	mGameWorld->SetFixedTimestepEnabled(true);
+	mGameWorld->SetTickRate(TICK_RATE);
+	// Draw the asteroids and explosions together rather than one by one
+	mGameWorld->SetSpriteBatchingEnabled(true);
+	mGameWorld->SetRenderStateSortingEnabled(true);
+
+	// Seed the asteroids from the recording being replayed, or afresh
+	uint seed = (uint)time(NULL);
+	if (!mReplayFilename.empty()) {
+		if (mInputReplayer.Load(mReplayFilename)) { seed = mInputReplayer.GetSeed(); }
+		else { std::cout << "Could not load replay " << mReplayFilename << std::endl; mReplayFilename.clear(); }
+	}
+	mGameWorld->SetRandomSeed(seed);
+	if (!mRecordFilename.empty() && mInputRecorder.Open(mRecordFilename, mGameWorld, seed)) {
+		mGameWorld->AddListener(&mInputRecorder);
+	}
+
 	// Add this as a listener to the world and the keyboard
 	mGameWindow->AddKeyboardListener(thisPtr);
 
 	// Add a score keeper to the game world
 	mGameWorld->AddListener(&mScoreKeeper);
 
+	// Add the bullet pool to the game world so it gets back removed bullets
+	mGameWorld->AddListener(&mBulletPool);
+
+	// Add the explosion pool to the game world so it gets back finished explosions
+	mGameWorld->AddListener(&mExplosionPool);
+
 	// Add this class as a listener of the score keeper
 	mScoreKeeper.AddListener(thisPtr);
 
@@ -58,6 +89,10 @@ void Asteroids::Start()
 	Animation *asteroid1_anim = AnimationManager::GetInstance().CreateAnimationFromFile("asteroid1", 128, 8192, 128, 128, "asteroid1_fs.png");
 	Animation *spaceship_anim = AnimationManager::GetInstance().CreateAnimationFromFile("spaceship", 128, 128, 128, 128, "spaceship_fs.png");
 
+	// Construct explosions now so destroying asteroids does not allocate them
+	mExplosionPool.SetAnimation(explosion_anim);
+	mExplosionPool.Reserve(EXPLOSION_POOL_CAPACITY);
+
 	// Create Custom Start Menu
 	CreateStartGUI();
 
@@ -79,6 +114,12 @@ void Asteroids::Start()
 	// Add this class as a listener of the player
 	mPlayer.AddListener(thisPtr);
 
+	// Take over from the keyboard and timers if replaying a recording
+	if (!mReplayFilename.empty()) {
+		mGameWorld->AddListener(&mInputReplayer);
+		mInputReplayer.Start(mGameWorld, this, this);
+	}
+
 	// Start the game
 	GameSession::Start();
 }
@@ -94,6 +135,8 @@ void Asteroids::Stop()
 
 void Asteroids::OnKeyPressed(uchar key, int x, int y)
 { 
+	if (!AcceptInput(InputEvent::KEY_PRESSED, key, x, y)) return;
+
 	if (mAskUser) {
 		// I feel like this should be in cases, as, this is not robust given that both exist if and cases exist.
 		// All characters within ASCII range
@@ -221,12 +264,14 @@ void Asteroids::OnKeyPressed(uchar key, int x, int y)
 }
 
 void Asteroids::OnKeyReleased(uchar key, int x, int y) {
+	if (!AcceptInput(InputEvent::KEY_RELEASED, key, x, y)) return;
 
 	
 }
 
 void Asteroids::OnSpecialKeyPressed(int key, int x, int y)
 {
+	if (!AcceptInput(InputEvent::SPECIAL_KEY_PRESSED, key, x, y)) return;
 	// as mentioned above this prevents crashing as should only apply when in game state
 	if (mGameStarted) {
 
@@ -254,6 +299,7 @@ void Asteroids::OnSpecialKeyPressed(int key, int x, int y)
 
 void Asteroids::OnSpecialKeyReleased(int key, int x, int y)
 {	
+	if (!AcceptInput(InputEvent::SPECIAL_KEY_RELEASED, key, x, y)) return;
 	// as mentioned above this prevents crashing as should only apply when in game state
 	if (mGameStarted) {
 
@@ -276,9 +322,23 @@ void Asteroids::OnSpecialKeyReleased(int key, int x, int y)
 
 // PUBLIC INSTANCE METHODS IMPLEMENTING IGameWorldListener ////////////////////
 
+void Asteroids::OnWorldUpdated(GameWorld* world)
+{
+	// Report whether a replay matched its recording frame by frame once it ends
+	if (mInputReplayer.IsReplaying() && mInputReplayer.IsFinished() && !mReplayReported) {
+		mReplayReported = true;
+		std::cout << "Replay finished at frame " << world->GetTickCount() << ", "
+			<< mInputReplayer.GetNumChecksMatched() << " frames matched";
+		if (!mInputReplayer.IsInSync()) std::cout << ", diverged at frame " << mInputReplayer.GetDivergedFrame();
+		std::cout << std::endl;
+		// Hand control back to the player
+		mInputReplayer.Stop();
+	}
+}
+
 void Asteroids::OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
 {
-	if (object->GetType() == GameObjectType("Asteroid"))
+	if (object->GetType() == ASTEROID_TYPE)
 	{
 		shared_ptr<GameObject> explosion = CreateExplosion();
 		explosion->SetPosition(object->GetPosition());
@@ -287,7 +347,7 @@ void Asteroids::OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
 		mAsteroidCount--;
 		if (mAsteroidCount <= 0) 
 		{ 
-			SetTimer(500, START_NEXT_LEVEL); 
+			SetGameTimer(500, START_NEXT_LEVEL); 
 		}
 	}
 }
@@ -296,6 +356,10 @@ void Asteroids::OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
 
 void Asteroids::OnTimer(int value)
 {
+	// Timers set during a replay that are still pending once it stops are stale
+	if (value & REPLAY_TIMER) return;
+	if (!AcceptInput(InputEvent::TIMER, value)) return;
+
 	if (value == CREATE_NEW_PLAYER)
 	{
 		mSpaceship->Reset();
@@ -321,6 +385,24 @@ void Asteroids::OnTimer(int value)
 }
 
 // PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Record an input if recording. While replaying, only recorded inputs are accepted,
+	as live keys and real-time timers would make the game diverge from the recording. */
+bool Asteroids::AcceptInput(InputEvent::Type type, int value, int x, int y)
+{
+	if (mInputReplayer.IsReplaying() && !mInputReplayer.IsDelivering()) return false;
+	mInputRecorder.Record(type, value, x, y);
+	return true;
+}
+
+/** Set a timer for the game. Timers set while replaying are marked, so that they
+	are dropped rather than taken as live if they fire after the replay stops. */
+void Asteroids::SetGameTimer(uint msecs, uint value)
+{
+	if (mInputReplayer.IsReplaying()) value |= REPLAY_TIMER;
+	SetTimer(msecs, value);
+}
+
 shared_ptr<GameObject> Asteroids::CreateSpaceship()
 {
 	// Create a raw pointer to a spaceship that can be converted to
@@ -329,6 +411,7 @@ shared_ptr<GameObject> Asteroids::CreateSpaceship()
 	mSpaceship->SetBoundingShape(make_shared<BoundingSphere>(mSpaceship->GetThisPtr(), 4.0f));
 	shared_ptr<Shape> bullet_shape = make_shared<Shape>("bullet.shape");
 	mSpaceship->SetBulletShape(bullet_shape);
+	mSpaceship->SetBulletPool(&mBulletPool);
 	Animation *anim_ptr = AnimationManager::GetInstance().GetAnimationByName("spaceship");
 	shared_ptr<Sprite> spaceship_sprite =
 		make_shared<Sprite>(anim_ptr->GetWidth(), anim_ptr->GetHeight(), anim_ptr);
@@ -350,7 +433,7 @@ void Asteroids::CreateAsteroids(const uint num_asteroids)
 		shared_ptr<Sprite> asteroid_sprite
 			= make_shared<Sprite>(anim_ptr->GetWidth(), anim_ptr->GetHeight(), anim_ptr);
 		asteroid_sprite->SetLoopAnimation(true);
-		shared_ptr<GameObject> asteroid = make_shared<Asteroid>();
+		shared_ptr<GameObject> asteroid = make_shared<Asteroid>(mGameWorld->GetRandom());
 		asteroid->SetBoundingShape(make_shared<BoundingSphere>(asteroid->GetThisPtr(), 10.0f));
 		asteroid->SetSprite(asteroid_sprite);
 		asteroid->SetScale(0.2f);
@@ -749,24 +832,18 @@ void Asteroids::OnPlayerKilled(int lives_left)
 
 	if (lives_left > 0) 
 	{ 
-		SetTimer(1000, CREATE_NEW_PLAYER); 
+		SetGameTimer(1000, CREATE_NEW_PLAYER); 
 	}
 	else
 	{
-		SetTimer(500, SHOW_GAME_OVER);
+		SetGameTimer(500, SHOW_GAME_OVER);
 	}
 }
 
 shared_ptr<GameObject> Asteroids::CreateExplosion()
 {
-	Animation *anim_ptr = AnimationManager::GetInstance().GetAnimationByName("explosion");
-	shared_ptr<Sprite> explosion_sprite =
-		make_shared<Sprite>(anim_ptr->GetWidth(), anim_ptr->GetHeight(), anim_ptr);
-	explosion_sprite->SetLoopAnimation(false);
-	shared_ptr<GameObject> explosion = make_shared<Explosion>();
-	explosion->SetSprite(explosion_sprite);
-	explosion->Reset();
-	return explosion;
+	// Take a rewound explosion from the pool, which grows if a burst uses them all
+	return mExplosionPool.Acquire();
 }
 
 
@@ -9,6 +9,10 @@
 #include "ScoreKeeper.h"
 #include "Player.h"
 #include "IPlayerListener.h"
+#include "BulletPool.h"
+#include "ExplosionPool.h"
+#include "InputRecorder.h"
+#include "InputReplayer.h"
 #include <vector>
 
 class GameObject;
@@ -41,7 +45,7 @@ public:
 
 	// Declaration of IGameWorldListener interface //////////////////////////////
 
-	void OnWorldUpdated(GameWorld* world) {}
+	void OnWorldUpdated(GameWorld* world);
 	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object) {}
 	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object);
 
@@ -145,6 +149,14 @@ private:
     const static uint SHOW_GAME_OVER = 0;
 	const static uint START_NEXT_LEVEL = 1;
 	const static uint CREATE_NEW_PLAYER = 2;
+	// Marks the values of timers set while replaying, which only the recording may deliver
+	const static uint REPLAY_TIMER = 0x100;
+	// Bullets constructed up front, enough for 2s of rapid fire
+	const static uint BULLET_POOL_CAPACITY = 64;
+	// Explosions constructed up front, enough to clear a large wave in one frame
+	const static uint EXPLOSION_POOL_CAPACITY = 64;
+	// Fixed ticks of the game world per second
+	const static uint TICK_RATE = 60;
 
 	//manage booleans states reliably
 	void GameStartedBoolean();
@@ -158,6 +170,20 @@ private:
 	// this player will be used more for part 2, but for part 1, going to use a struct for
 	// storing value and lives
 	Player mPlayer;
+
+	// Recycles the spaceship's bullets once they leave the world
+	BulletPool mBulletPool;
+	// Recycles explosions once their animation has finished
+	ExplosionPool mExplosionPool;
+
+	// Records inputs to, or replays them from, the files named on the command line
+	string mRecordFilename;
+	string mReplayFilename;
+	InputRecorder mInputRecorder;
+	InputReplayer mInputReplayer;
+	bool mReplayReported;
+	bool AcceptInput(InputEvent::Type type, int value, int x = 0, int y = 0);
+	void SetGameTimer(uint msecs, uint value);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "Asteroid.h"
+#include "Spaceship.h"
+#include "Bullet.h"
+#include "BoundingSphere.h"
+#include "ObjectTypes.h"
+#include "AsteroidsAgentSession.h"
+#include "StateStream.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Construct a session playing the asteroids game without a window, sprites or
+	explosions, for agents to play through its controls. Episodes last at most
+	two minutes of simulated time by default. */
+AsteroidsAgentSession::AsteroidsAgentSession(void)
+	: mLevel(0),
+	  mMaxEpisodeTime(120000)
+{
+}
+
+/** Destructor. */
+AsteroidsAgentSession::~AsteroidsAgentSession(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Hold down the controls given by the bits of action, as the arrow keys and
+	space bar do in the game. Shooting fires one bullet per action. */
+void AsteroidsAgentSession::Act(uint action)
+{
+	mSpaceship->Thrust((action & ACTION_THRUST) ? 10.0f : 0.0f);
+	float rotation = 0;
+	if (action & ACTION_LEFT) rotation += 90;
+	if (action & ACTION_RIGHT) rotation -= 90;
+	mSpaceship->Rotate(rotation);
+	if ((action & ACTION_SHOOT) && mGameWorld->IsInWorld(mSpaceship.get())) mSpaceship->Shoot();
+}
+
+/** Write an observation of the episode as it stands. */
+void AsteroidsAgentSession::Observe(float* observation)
+{
+	GLVector3f position = mSpaceship->GetPosition();
+	GLVector3f velocity = mSpaceship->GetVelocity();
+	observation[0] = position.x;
+	observation[1] = position.y;
+	observation[2] = velocity.x;
+	observation[3] = velocity.y;
+	observation[4] = mSpaceship->GetAngle();
+	observation[5] = mGameWorld->IsInWorld(mSpaceship.get()) ? 1.0f : 0.0f;
+	observation[6] = (float)mPlayer.GetLives();
+	observation[7] = (float)mScoreKeeper.GetScore();
+
+	// Rank the asteroids by distance the short way round the world
+	mNearest.clear();
+	for (uint i = 0; i < (uint)mAsteroids.size(); i++) {
+		GLVector3f offset = mAsteroids[i]->GetPosition() - position;
+		mGameWorld->WrapOffset(offset.x, offset.y);
+		mNearest.push_back(make_pair(offset.lengthSqr(), i));
+	}
+	uint n = min((uint)mNearest.size(), NUM_OBSERVED_ASTEROIDS);
+	partial_sort(mNearest.begin(), mNearest.begin() + n, mNearest.end());
+
+	float* asteroid = observation + 8;
+	for (uint i = 0; i < NUM_OBSERVED_ASTEROIDS; i++, asteroid += 4) {
+		if (i >= n) {
+			asteroid[0] = asteroid[1] = asteroid[2] = asteroid[3] = 0;
+			continue;
+		}
+		GameObject* object = mAsteroids[mNearest[i].second].get();
+		GLVector3f offset = object->GetPosition() - position;
+		mGameWorld->WrapOffset(offset.x, offset.y);
+		asteroid[0] = offset.x;
+		asteroid[1] = offset.y;
+		asteroid[2] = object->GetVelocity().x;
+		asteroid[3] = object->GetVelocity().y;
+	}
+}
+
+/** An episode is over when the last life is lost or its time runs out. */
+bool AsteroidsAgentSession::IsEpisodeOver(void)
+{
+	if (mPlayer.GetLives() <= 0) return true;
+	return mMaxEpisodeTime > 0 && mElapsedTime >= mMaxEpisodeTime;
+}
+
+/** Save the state of the episode. The spaceship is saved even when it is waiting
+	to be put back in the world, and asteroids are saved by where they are in the
+	world so that they are observed in the same order once restored. */
+void AsteroidsAgentSession::SaveState(StateWriter& writer)
+{
+	AgentSession::SaveState(writer);
+	writer.Write(mLevel);
+	mScoreKeeper.SaveState(writer);
+	mPlayer.SaveState(writer);
+	mSpaceship->SaveState(writer);
+	writer.Write((uint)mAsteroids.size());
+	for (uint i = 0; i < (uint)mAsteroids.size(); i++) writer.Write(mAsteroids[i]->GetWorldIndex());
+}
+
+/** Restore the state saved by SaveState. */
+bool AsteroidsAgentSession::RestoreState(StateReader& reader)
+{
+	mRestoredObjects.clear();
+	bool restored = AgentSession::RestoreState(reader);
+	if (restored) {
+		reader.Read(mLevel);
+		mScoreKeeper.RestoreState(reader);
+		mPlayer.RestoreState(reader);
+		mSpaceship->RestoreState(reader);
+		uint num_asteroids = 0;
+		reader.Read(num_asteroids);
+		mAsteroids.clear();
+		for (uint i = 0; i < num_asteroids && !reader.HasFailed(); i++) {
+			uint index = 0;
+			reader.Read(index);
+			if (index >= (uint)mRestoredObjects.size()) return false;
+			mAsteroids.push_back(mRestoredObjects[index]);
+		}
+	}
+	mRestoredObjects.clear();
+	return restored && !reader.HasFailed();
+}
+
+// PUBLIC INSTANCE METHODS IMPLEMENTING IGameWorldListener ////////////////////
+
+void AsteroidsAgentSession::OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object)
+{
+	if (object->GetType() == ASTEROID_TYPE) mAsteroids.push_back(object);
+}
+
+void AsteroidsAgentSession::OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
+{
+	if (object->GetType() == ASTEROID_TYPE) {
+		vector< shared_ptr<GameObject> >::iterator it = find(mAsteroids.begin(), mAsteroids.end(), object);
+		if (it != mAsteroids.end()) mAsteroids.erase(it);
+		if (mAsteroids.empty()) SetTimer(500, START_NEXT_LEVEL);
+	}
+	// The player has already counted the life lost
+	if (object->GetType() == SPACESHIP_TYPE && mPlayer.GetLives() > 0) {
+		SetTimer(1000, CREATE_NEW_PLAYER);
+	}
+}
+
+// PUBLIC INSTANCE METHODS IMPLEMENTING ITimerListener ////////////////////////
+
+void AsteroidsAgentSession::OnTimer(int value)
+{
+	if (value == CREATE_NEW_PLAYER) {
+		mSpaceship->Reset();
+		mGameWorld->AddObject(mSpaceship);
+	}
+
+	if (value == START_NEXT_LEVEL) {
+		mLevel++;
+		CreateAsteroids(10 + 2 * mLevel);
+	}
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Start an episode as the game starts: a spaceship at the centre of the world
+	with three lives, and ten asteroids placed by the world's generator. */
+void AsteroidsAgentSession::StartEpisode(void)
+{
+	mScoreKeeper = ScoreKeeper();
+	mPlayer = Player();
+	mLevel = 0;
+	mAsteroids.clear();
+
+	// The score keeper and player count each removal before this session sees it
+	mGameWorld->AddListener(&mScoreKeeper);
+	mGameWorld->AddListener(&mPlayer);
+	mGameWorld->AddListener(this);
+
+	mSpaceship = make_shared<Spaceship>();
+	mSpaceship->SetBoundingShape(make_shared<BoundingSphere>(mSpaceship->GetThisPtr(), 4.0f));
+	mSpaceship->Reset();
+	mGameWorld->AddObject(mSpaceship);
+	CreateAsteroids(10);
+}
+
+/** Add asteroids at random positions. */
+void AsteroidsAgentSession::CreateAsteroids(uint num_asteroids)
+{
+	for (uint i = 0; i < num_asteroids; i++) {
+		shared_ptr<GameObject> asteroid = make_shared<Asteroid>(mGameWorld->GetRandom());
+		asteroid->SetBoundingShape(make_shared<BoundingSphere>(asteroid->GetThisPtr(), 10.0f));
+		mGameWorld->AddObject(asteroid);
+	}
+}
+
+/** Create an object of a saved type to restore into the world. The spaceship is
+	the session's own, and asteroids are placed by a generator of their own so as
+	not to draw from the world's, whose state is restored after them. */
+shared_ptr<GameObject> AsteroidsAgentSession::CreateObject(uint type_id)
+{
+	shared_ptr<GameObject> object;
+	if (type_id == (uint)SPACESHIP_TYPE.GetTypeID()) {
+		object = mSpaceship;
+	} else if (type_id == (uint)ASTEROID_TYPE.GetTypeID()) {
+		Random random;
+		object = make_shared<Asteroid>(random);
+		object->SetBoundingShape(make_shared<BoundingSphere>(object->GetThisPtr(), 10.0f));
+	} else if (type_id == (uint)BULLET_TYPE.GetTypeID()) {
+		object = make_shared<Bullet>();
+		object->SetBoundingShape(make_shared<BoundingSphere>(object->GetThisPtr(), 2.0f));
+	}
+	if (object.get() != NULL) mRestoredObjects.push_back(object);
+	return object;
+}
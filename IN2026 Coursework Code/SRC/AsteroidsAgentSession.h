@@ -0,0 +1,81 @@
+#ifndef __ASTEROIDSAGENTSESSION_H__
+#define __ASTEROIDSAGENTSESSION_H__
+
+#include "GameUtil.h"
+#include "AgentSession.h"
+#include "IGameWorldListener.h"
+#include "ScoreKeeper.h"
+#include "Player.h"
+#include <vector>
+
+class GameObject;
+class Spaceship;
+
+class AsteroidsAgentSession : public AgentSession, public IGameWorldListener
+{
+public:
+	// Bits of an action, each holding down one of the game's controls
+	const static uint ACTION_THRUST = 1 << 0;
+	const static uint ACTION_LEFT = 1 << 1;
+	const static uint ACTION_RIGHT = 1 << 2;
+	const static uint ACTION_SHOOT = 1 << 3;
+
+	// An observation is the spaceship's position, velocity and angle, whether
+	// it is alive, the lives and score, then the offset and velocity of the
+	// nearest asteroids, nearest first, padded with zeros. These are constexpr so
+	// that passing them by reference, as min does, needs no definition elsewhere
+	static constexpr uint NUM_OBSERVED_ASTEROIDS = 8;
+	static constexpr uint OBSERVATION_SIZE = 8 + 4 * NUM_OBSERVED_ASTEROIDS;
+
+	AsteroidsAgentSession(void);
+	virtual ~AsteroidsAgentSession(void);
+
+	void Act(uint action);
+	void Observe(float* observation);
+	uint GetObservationSize(void) { return OBSERVATION_SIZE; }
+	bool IsEpisodeOver(void);
+
+	void SetMaxEpisodeTime(uint msecs) { mMaxEpisodeTime = msecs; }
+	uint GetMaxEpisodeTime() { return mMaxEpisodeTime; }
+
+	int GetScore() { return mScoreKeeper.GetScore(); }
+	int GetLives() { return mPlayer.GetLives(); }
+	uint GetLevel() { return mLevel; }
+
+	void SaveState(StateWriter& writer);
+	bool RestoreState(StateReader& reader);
+
+	// Declaration of IGameWorldListener interface //////////////////////////////
+
+	void OnWorldUpdated(GameWorld* world) {}
+	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object);
+	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object);
+
+	// Override the default implementation of ITimerListener ////////////////////
+	void OnTimer(int value);
+
+protected:
+	void StartEpisode(void);
+	void CreateAsteroids(uint num_asteroids);
+	shared_ptr<GameObject> CreateObject(uint type_id);
+
+	shared_ptr<Spaceship> mSpaceship;
+	ScoreKeeper mScoreKeeper;
+	Player mPlayer;
+	uint mLevel;
+
+	// Asteroids in the world, to find the nearest of
+	vector< shared_ptr<GameObject> > mAsteroids;
+	// Squared distance of each asteroid from the spaceship and its index, reused each observation
+	vector< pair< float, uint > > mNearest;
+	// Objects created while restoring a state, in world order
+	vector< shared_ptr<GameObject> > mRestoredObjects;
+
+	// Simulated milliseconds after which an episode ends, or 0 for no limit
+	uint mMaxEpisodeTime;
+
+	const static int START_NEXT_LEVEL = 1;
+	const static int CREATE_NEW_PLAYER = 2;
+};
+
+#endif
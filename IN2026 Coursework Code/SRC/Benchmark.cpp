@@ -0,0 +1,620 @@
+// Engine microbenchmarks, run from the console without a window
+
+#include <chrono>
+#include <iostream>
+
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "GameObject.h"
+#include "AsteroidsAgentSession.h"
+#include "BoundingSphere.h"
+#include "HeadlessSession.h"
+#include "IKeyboardListener.h"
+#include "InputRecorder.h"
+#include "InputReplayer.h"
+#include "JobSystem.h"
+#include "KinematicsKernel.h"
+#include "KinematicsStore.h"
+#include "Random.h"
+#include "RenderCuller.h"
+#include "SnapshotRing.h"
+#include "StateStream.h"
+#include "WorldRunner.h"
+#include "WorldSnapshot.h"
+
+// Number of bodies in each benchmark world
+static const uint NUM_BODIES = 20000;
+// Number of frames to time for each benchmark
+static const uint NUM_FRAMES = 500;
+// Frame time in milliseconds
+static const int FRAME_TIME = 16;
+
+/** Get the starting position of a body, in a fixed pattern so every run is the same. */
+static GLVector3f BodyPosition(uint i) { return GLVector3f((float)(i % 400) - 200, (float)((i * 7) % 400) - 200, 0); }
+static GLVector3f BodyVelocity(uint i) { return GLVector3f((float)(i % 61) - 30, (float)(i % 53) - 26, 0); }
+static GLVector3f BodyAcceleration(uint i) { return GLVector3f((float)(i % 5) - 2, (float)(i % 3) - 1, 0); }
+
+/** Fill a world with moving bodies. */
+static void PopulateWorld(GameWorld& world)
+{
+	world.SetWidth(400);
+	world.SetHeight(400);
+	for (uint i = 0; i < NUM_BODIES; i++) {
+		world.AddObject(make_shared<GameObject>("Body", BodyPosition(i), BodyVelocity(i), BodyAcceleration(i), (float)(i % 360), (float)(i % 90)));
+	}
+}
+
+/** Time NUM_FRAMES integrations of a kinematics store and return the average milliseconds per frame. */
+static double TimeStoreIntegration()
+{
+	KinematicsStore store;
+	for (uint i = 0; i < NUM_BODIES; i++) {
+		store.Add(BodyPosition(i), BodyVelocity(i), BodyAcceleration(i), (float)(i % 360), (float)(i % 90));
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < NUM_FRAMES; i++) store.Integrate(FRAME_TIME, 400, 400);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / NUM_FRAMES;
+}
+
+/** Time NUM_FRAMES world updates and return the average milliseconds per frame. */
+static double TimeWorldUpdates(GameWorld& world)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < NUM_FRAMES; i++) world.Update(FRAME_TIME);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / NUM_FRAMES;
+}
+
+/** Compare integrating each object in turn with integrating the kinematics store
+	using each kernel this processor supports. */
+static void BenchmarkIntegration()
+{
+	std::cout << "Integration, " << NUM_BODIES << " bodies, " << NUM_FRAMES << " frames" << std::endl;
+
+	{
+		GameWorld world;
+		PopulateWorld(world);
+		std::cout << "  per object:    " << TimeWorldUpdates(world) << " ms/frame" << std::endl;
+	}
+
+	KinematicsKernel default_kernel = GetKinematicsKernel();
+	KinematicsKernel kernels[] = { IntegrateKinematicsScalar, IntegrateKinematicsSSE2, IntegrateKinematicsAVX };
+	for (uint k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+		if (!IsKinematicsKernelSupported(kernels[k])) {
+			std::cout << "  store " << GetKinematicsKernelName(kernels[k]) << ": not supported" << std::endl;
+			continue;
+		}
+		SetKinematicsKernel(kernels[k]);
+		GameWorld world;
+		world.SetKinematicsStoreEnabled(true);
+		PopulateWorld(world);
+		std::cout << "  store " << GetKinematicsKernelName(kernels[k]) << ": " << TimeWorldUpdates(world) << " ms/frame, ";
+		std::cout << TimeStoreIntegration() << " ms/frame integrating alone" << std::endl;
+	}
+	SetKinematicsKernel(default_kernel);
+}
+
+/** A headless session that sets a repeating timer, as games do to spawn waves. */
+class TimerCountingSession : public HeadlessSession
+{
+public:
+	TimerCountingSession() : HeadlessSession(400, 400), mNumTimers(0) {}
+
+	void Start(void)
+	{
+		HeadlessSession::Start();
+		SetTimer(100, 0);
+	}
+
+	void OnTimer(int value)
+	{
+		mNumTimers++;
+		SetTimer(100, value);
+	}
+
+	uint GetNumTimers() { return mNumTimers; }
+
+private:
+	uint mNumTimers;
+};
+
+/** Run a headless session as fast as possible and report simulated frames per second. */
+static void BenchmarkHeadless()
+{
+	const uint num_frames = 10000;
+	std::cout << "Headless session, " << NUM_BODIES / 10 << " bodies, " << num_frames << " frames" << std::endl;
+
+	TimerCountingSession session;
+	GameWorld* world = session.GetWorld();
+	for (uint i = 0; i < NUM_BODIES / 10; i++) {
+		world->AddObject(make_shared<GameObject>("Body", BodyPosition(i), BodyVelocity(i), BodyAcceleration(i), (float)(i % 360), (float)(i % 90)));
+	}
+	session.Start();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	session.Run(num_frames, FRAME_TIME);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "  " << num_frames / elapsed.count() << " frames/s, ";
+	std::cout << session.GetElapsedTime() / (1000 * elapsed.count()) << "x real time, ";
+	std::cout << session.GetNumTimers() << " timers fired" << std::endl;
+}
+
+/** A headless game whose keys steer the most recently added body and whose
+	timer adds a body at a random position, as a game spawns asteroids. */
+class ReplayableSession : public HeadlessSession, public IKeyboardListener
+{
+public:
+	ReplayableSession() : HeadlessSession(400, 400) {}
+
+	void Start(uint seed)
+	{
+		mGameWorld->SetRandomSeed(seed);
+		mGameWorld->SetFixedTimestepEnabled(true);
+		mGameWorld->AddListener(&mRecorder);
+		mGameWorld->AddListener(&mReplayer);
+		for (uint i = 0; i < NUM_BODIES / 10; i++) SpawnBody();
+		HeadlessSession::Start();
+		SetTimer(250, 0);
+	}
+
+	void OnKeyPressed(uchar key, int x, int y)
+	{
+		if (!AcceptInput(InputEvent::KEY_PRESSED, key)) return;
+		mLastBody->SetVelocity(GLVector3f((float)(key % 7) - 3, (float)(key % 5) - 2, 0) * 10);
+	}
+	void OnKeyReleased(uchar key, int x, int y) {}
+	void OnSpecialKeyPressed(int key, int x, int y) {}
+	void OnSpecialKeyReleased(int key, int x, int y) {}
+
+	void OnTimer(int value)
+	{
+		if (!AcceptInput(InputEvent::TIMER, value)) return;
+		SpawnBody();
+		SetTimer(250, value);
+	}
+
+	InputRecorder mRecorder;
+	InputReplayer mReplayer;
+
+private:
+	bool AcceptInput(InputEvent::Type type, int value)
+	{
+		if (mReplayer.IsReplaying() && !mReplayer.IsDelivering()) return false;
+		mRecorder.Record(type, value);
+		return true;
+	}
+
+	void SpawnBody()
+	{
+		Random& random = mGameWorld->GetRandom();
+		GLVector3f position(random.NextFloat(-200, 200), random.NextFloat(-200, 200), 0);
+		mLastBody = make_shared<GameObject>("Body", position, GLVector3f(5, 5, 0), GLVector3f(0, 0, 0), random.NextFloat(0, 360), 45.0f);
+		mGameWorld->AddObject(mLastBody);
+	}
+
+	shared_ptr<GameObject> mLastBody;
+};
+
+/** Record a headless game driven by irregular frame times and key presses, then
+	replay it headlessly at a steady frame time and compare them frame by frame. */
+static void BenchmarkReplay()
+{
+	const uint num_frames = 5000;
+	const char* filename = "benchmark_replay.bin";
+	std::cout << "Replay, " << num_frames << " frames" << std::endl;
+
+	uint recorded_ticks;
+	{
+		ReplayableSession session;
+		session.mRecorder.Open(filename, session.GetWorld(), 1234);
+		session.Start(1234);
+		for (uint i = 0; i < num_frames; i++) {
+			if (i % 37 == 0) session.OnKeyPressed((uchar)(i % 128), 0, 0);
+			session.Tick(5 + (i * 7) % 40);
+		}
+		session.mRecorder.Close();
+		recorded_ticks = (uint)session.GetWorld()->GetTickCount();
+	}
+
+	ReplayableSession session;
+	if (!session.mReplayer.Load(filename)) {
+		std::cout << "  could not load " << filename << std::endl;
+		return;
+	}
+	session.Start(session.mReplayer.GetSeed());
+	session.mReplayer.Start(session.GetWorld(), &session, &session);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (session.GetWorld()->GetTickCount() < recorded_ticks) session.Tick(16);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "  " << recorded_ticks / elapsed.count() << " ticks/s, ";
+	std::cout << session.mReplayer.GetNumChecksMatched() << " of " << recorded_ticks << " frames matched";
+	if (!session.mReplayer.IsInSync()) std::cout << ", diverged at frame " << session.mReplayer.GetDivergedFrame();
+	std::cout << std::endl;
+	remove(filename);
+}
+
+/** Compare drawing from libc's rand with drawing from a world's generator. */
+static void BenchmarkRandom()
+{
+	const uint num_draws = 10000000;
+	std::cout << "Random, " << num_draws << " draws" << std::endl;
+
+	uint sum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < num_draws; i++) sum += rand() % 360;
+	std::chrono::duration<double> libc_elapsed = std::chrono::steady_clock::now() - start;
+
+	Random random(1234);
+	start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < num_draws; i++) sum += random.Next(360);
+	std::chrono::duration<double> world_elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << "  rand:   " << num_draws / (1e6 * libc_elapsed.count()) << " M draws/s" << std::endl;
+	std::cout << "  Random: " << num_draws / (1e6 * world_elapsed.count()) << " M draws/s (checksum " << sum % 1000 << ")" << std::endl;
+}
+
+/** Time culling bodies spread over a large world against a view of a sixteenth
+	of it, and check the culler finds the bodies overlapping the view in order. */
+static void BenchmarkCulling()
+{
+	const float world_size = 4000;
+	const float view_size = 1000;
+	std::cout << "Culling, " << NUM_BODIES << " bodies, " << NUM_FRAMES << " frames" << std::endl;
+
+	Random random(1234);
+	BroadphaseProxyList proxies(NUM_BODIES);
+	for (uint i = 0; i < NUM_BODIES; i++) {
+		proxies[i].object = NULL;
+		proxies[i].x = random.NextFloat(-world_size / 2, world_size / 2);
+		proxies[i].y = random.NextFloat(-world_size / 2, world_size / 2);
+		proxies[i].radius = random.NextFloat(1, 20);
+	}
+	float left = 200, bottom = -300, right = left + view_size, top = bottom + view_size;
+
+	RenderCuller culler;
+	vector<uint> visible;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint f = 0; f < NUM_FRAMES; f++) {
+		culler.Cull(proxies, left, bottom, right, top, visible);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// Circles whose centres are inside the view, which must all be found
+	uint num_inside = 0;
+	bool ordered = true;
+	for (uint i = 0; i < visible.size(); i++) {
+		const BroadphaseProxy& p = proxies[visible[i]];
+		if (p.x >= left && p.x <= right && p.y >= bottom && p.y <= top) num_inside++;
+		if (i > 0 && visible[i] <= visible[i - 1]) ordered = false;
+	}
+	uint expected_inside = 0;
+	for (uint i = 0; i < NUM_BODIES; i++) {
+		const BroadphaseProxy& p = proxies[i];
+		if (p.x >= left && p.x <= right && p.y >= bottom && p.y <= top) expected_inside++;
+	}
+
+	std::cout << "  " << 1000 * elapsed.count() / NUM_FRAMES << " ms/frame, " << culler.GetNumProxiesTested() << " bodies tested, ";
+	std::cout << visible.size() << " visible";
+	if (!ordered || num_inside != expected_inside) std::cout << ", MISSED bodies in the view";
+	std::cout << std::endl;
+}
+
+/** A body with enough work in its update to be worth spreading across threads.
+	When its life runs out it removes itself and adds a body in its place. */
+class BusyBody : public GameObject
+{
+public:
+	BusyBody(GLVector3f p, GLVector3f v, int life) : GameObject("Body", p, v, GLVector3f(0, 0, 0), 0, 0), mLife(life) {}
+
+	void Update(int t)
+	{
+		GameObject::Update(t);
+		// Turn towards the centre of the world
+		GLVector3f velocity = GetVelocity();
+		GLVector3f position = GetPosition();
+		float bearing = (float)atan2(-position.y, -position.x);
+		float turn = 0;
+		for (int i = 1; i <= 16; i++) turn += (float)sin(bearing * i) / i;
+		SetVelocity(GLVector3f(velocity.x - velocity.y * turn * 0.001f, velocity.y + velocity.x * turn * 0.001f, 0));
+		mLife -= t;
+		if (mLife <= 0) {
+			mWorld->FlagForRemoval(GetThisPtr());
+			mWorld->AddObject(make_shared<BusyBody>(position, GLVector3f(velocity.y, -velocity.x, 0), 1000 + (int)(GetWorldIndex() % 1000)));
+		}
+	}
+
+private:
+	int mLife;
+};
+
+/** Time updating a world of busy bodies serially and across a job system with
+	increasing numbers of threads, checking that every run ends in the same state. */
+static void BenchmarkParallelUpdate()
+{
+	const uint num_frames = 100;
+	std::cout << "Parallel update, " << NUM_BODIES << " bodies, " << num_frames << " frames, ";
+	std::cout << thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+	uint serial_checksum = 0;
+	double serial_time = 0;
+	uint max_threads = max(thread::hardware_concurrency(), 4u);
+	for (uint num_threads = 0; num_threads <= max_threads; num_threads = max(num_threads * 2, 1u)) {
+		JobSystem job_system(max(num_threads, 1u));
+		GameWorld world;
+		world.SetWidth(400);
+		world.SetHeight(400);
+		if (num_threads > 0) world.SetJobSystem(&job_system);
+		for (uint i = 0; i < NUM_BODIES; i++) {
+			world.AddObject(make_shared<BusyBody>(BodyPosition(i), BodyVelocity(i), 500 + (int)(i % 1000)));
+		}
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint f = 0; f < num_frames; f++) world.Update(FRAME_TIME);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		uint checksum = world.GetStateChecksum();
+		if (num_threads == 0) {
+			serial_checksum = checksum;
+			serial_time = elapsed.count();
+			std::cout << "  serial:    ";
+		} else {
+			std::cout << "  " << num_threads << (num_threads < 10 ? " threads: " : " threads:");
+		}
+		std::cout << 1000 * elapsed.count() / num_frames << " ms/frame, " << serial_time / elapsed.count() << "x";
+		if (checksum != serial_checksum) std::cout << ", DIFFERS from serial";
+		std::cout << std::endl;
+	}
+}
+
+// Hash of every collision reported to a crowded body, in the order reported
+static uint collision_hash = 0;
+
+/** A body with a bounding sphere that records the collisions it is told of. */
+class CrowdedBody : public GameObject
+{
+public:
+	CrowdedBody(GLVector3f p, GLVector3f v) : GameObject("Body", p, v, GLVector3f(0, 0, 0), 0, 0) {}
+
+	bool CollisionTest(shared_ptr<GameObject> o)
+	{
+		if (o->GetBoundingShape().get() == NULL) return false;
+		return mBoundingShape->CollisionTest(o->GetBoundingShape());
+	}
+
+	void OnCollision(const GameObjectSpan& objects)
+	{
+		collision_hash = collision_hash * 31 + GetWorldIndex();
+		for (GameObjectSpan::iterator it = objects.begin(); it != objects.end(); ++it) {
+			collision_hash = collision_hash * 31 + (*it)->GetWorldIndex();
+		}
+	}
+};
+
+/** Time finding the collisions of a crowded world serially and with the narrowphase
+	across increasing numbers of threads, checking that every run reports the same
+	collisions in the same order. Objects are updated serially throughout. */
+static void BenchmarkParallelCollisions()
+{
+	const uint num_frames = 100;
+	std::cout << "Parallel narrowphase, " << NUM_BODIES << " bodies, " << num_frames << " frames" << std::endl;
+
+	uint serial_hash = 0;
+	double serial_time = 0;
+	uint max_threads = max(thread::hardware_concurrency(), 4u);
+	for (uint num_threads = 0; num_threads <= max_threads; num_threads = max(num_threads * 2, 1u)) {
+		JobSystem job_system(max(num_threads, 1u));
+		GameWorld world;
+		world.SetWidth(1000);
+		world.SetHeight(1000);
+		world.SetUpdateChunkSize(NUM_BODIES);
+		if (num_threads > 0) world.SetJobSystem(&job_system);
+		Random random(1);
+		for (uint i = 0; i < NUM_BODIES; i++) {
+			GLVector3f position(random.NextFloat(-500, 500), random.NextFloat(-500, 500), 0);
+			shared_ptr<CrowdedBody> body = make_shared<CrowdedBody>(position, BodyVelocity(i));
+			body->SetBoundingShape(make_shared<BoundingSphere>(body->GetThisPtr(), 2.0f));
+			world.AddObject(body);
+		}
+		collision_hash = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint f = 0; f < num_frames; f++) world.Update(FRAME_TIME);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (num_threads == 0) {
+			serial_hash = collision_hash;
+			serial_time = elapsed.count();
+			std::cout << "  serial:    ";
+		} else {
+			std::cout << "  " << num_threads << (num_threads < 10 ? " threads: " : " threads:");
+		}
+		std::cout << 1000 * elapsed.count() / num_frames << " ms/frame, " << serial_time / elapsed.count() << "x";
+		if (collision_hash != serial_hash) std::cout << ", DIFFERS from serial";
+		std::cout << std::endl;
+	}
+}
+
+/** Play many asteroids games at once with random actions, stepping them across
+	increasing numbers of threads, and check every run observes the same games. */
+static void BenchmarkWorldRunner()
+{
+	const uint num_worlds = 256;
+	const uint num_steps = 500;
+	std::cout << "World runner, " << num_worlds << " asteroids games, " << num_steps << " steps of 4 frames" << std::endl;
+
+	uint serial_hash = 0;
+	double serial_rate = 0;
+	uint max_threads = max(thread::hardware_concurrency(), 4u);
+	for (uint num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+		WorldRunner runner(num_worlds, [](uint index) { return new AsteroidsAgentSession(); }, num_threads);
+		runner.SetFramesPerStep(4);
+		vector<float> observations;
+		vector<uint> actions(num_worlds);
+		vector<uchar> done;
+		Random random(7);
+		uint hash = 2166136261u;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		runner.Reset(99, observations);
+		for (uint s = 0; s < num_steps; s++) {
+			for (uint i = 0; i < num_worlds; i++) actions[i] = random.Next(16);
+			runner.Step(actions, observations, done);
+			// Fold in a little of every observation
+			for (uint i = 0; i < num_worlds; i++) {
+				const float* observation = &observations[i * runner.GetObservationSize()];
+				hash = (hash ^ (uint)(observation[0] * 1000) ^ (uint)observation[7] ^ done[i]) * 16777619u;
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		double rate = runner.GetNumFramesRun() / elapsed.count();
+		if (num_threads == 1) {
+			serial_hash = hash;
+			serial_rate = rate;
+		}
+		std::cout << "  " << num_threads << (num_threads < 10 ? " threads: " : " threads:");
+		std::cout << rate << " frames/s, " << rate / serial_rate << "x, ";
+		std::cout << runner.GetNumEpisodesFinished() << " episodes finished";
+		if (hash != serial_hash) std::cout << ", DIFFERS from 1 thread";
+		std::cout << std::endl;
+	}
+}
+
+/** Time writing snapshots of a world into a buffer, then run the world writing a
+	snapshot into a ring file every tick and check the latest one reads back whole. */
+static void BenchmarkSnapshot()
+{
+	const char* filename = "benchmark_snapshots.bin";
+	std::cout << "Snapshot, " << NUM_BODIES << " bodies, " << NUM_FRAMES << " frames" << std::endl;
+
+	GameWorld world;
+	world.SetWidth(400);
+	world.SetHeight(400);
+	world.SetFixedTimestepEnabled(true);
+	for (uint i = 0; i < NUM_BODIES; i++) {
+		shared_ptr<GameObject> body = make_shared<GameObject>("Body", BodyPosition(i), BodyVelocity(i), BodyAcceleration(i), (float)(i % 360), 0.0f);
+		if (i % 2 == 0) body->SetBoundingShape(make_shared<BoundingSphere>(body->GetThisPtr(), 1.0f));
+		world.AddObject(body);
+	}
+
+	vector<uchar> buffer(world.GetSnapshotSize());
+	uint size = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint f = 0; f < NUM_FRAMES; f++) size = world.WriteSnapshot(&buffer[0], (uint)buffer.size());
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "  to buffer: " << 1000 * elapsed.count() / NUM_FRAMES << " ms/frame, ";
+	std::cout << 1e9 * elapsed.count() / NUM_FRAMES / NUM_BODIES << " ns/object, " << size << " bytes" << std::endl;
+
+	SnapshotRing ring;
+	if (!ring.Open(filename, world.GetSnapshotSize(), 64)) {
+		std::cout << "  could not open " << filename << std::endl;
+		return;
+	}
+	world.AddListener(&ring);
+	start = std::chrono::steady_clock::now();
+	for (uint f = 0; f < NUM_FRAMES; f++) world.Update(FRAME_TIME);
+	elapsed = std::chrono::steady_clock::now() - start;
+
+	// The latest snapshot in the ring is of the world as it is now
+	vector<uchar> latest(buffer.size());
+	size = ring.ReadLatest(&latest[0], (uint)latest.size());
+	world.WriteSnapshot(&buffer[0], (uint)buffer.size());
+	SnapshotHeader header;
+	bool valid = ReadSnapshotHeader(&latest[0], size, header);
+	std::cout << "  to ring:   " << 1000 * elapsed.count() / NUM_FRAMES << " ms/frame with updates, ";
+	std::cout << ring.GetNumWritten() << " written, latest at tick " << (valid ? header.tick : 0);
+	if (!valid || latest != buffer) std::cout << ", DIFFERS from the world";
+	std::cout << std::endl;
+	ring.Close();
+	remove(filename);
+}
+
+/** Play an asteroids game keeping its state every frame, then go back five
+	seconds and play the same actions again, both in the same session and in a
+	second session branched from the kept state, checking both end where the
+	first play did. */
+static void BenchmarkRewind()
+{
+	const uint num_frames = 1500;
+	const uint rewind_time = 5000;
+	std::cout << "Rewind, asteroids game, " << num_frames << " frames, keeping 10 s" << std::endl;
+
+	vector<uint> actions(num_frames);
+	Random random(11);
+	for (uint f = 0; f < num_frames; f++) actions[f] = random.Next(16);
+
+	// Play without keeping states for comparison
+	AsteroidsAgentSession plain;
+	plain.Reset(5);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint f = 0; f < num_frames; f++) {
+		plain.Act(actions[f]);
+		plain.Tick(FRAME_TIME);
+	}
+	std::chrono::duration<double> plain_elapsed = std::chrono::steady_clock::now() - start;
+
+	AsteroidsAgentSession session;
+	session.SetRewindCapacity(10000 / FRAME_TIME, 60);
+	session.Reset(5);
+	start = std::chrono::steady_clock::now();
+	for (uint f = 0; f < num_frames; f++) {
+		session.Act(actions[f]);
+		session.Tick(FRAME_TIME);
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	vector<uchar> final_state;
+	StateWriter writer(final_state);
+	session.SaveState(writer);
+
+	StateRing& ring = session.GetRewindRing();
+	std::cout << "  keeping:   " << 1000 * elapsed.count() / num_frames << " ms/frame, ";
+	std::cout << 1000 * plain_elapsed.count() / num_frames << " ms/frame without, ";
+	std::cout << final_state.size() << " bytes a state, " << ring.GetSize() << " kept in " << ring.GetNumBytes() << " bytes, ";
+	std::cout << (double)ring.GetNumStateBytes() / ring.GetNumBytes() << "x smaller" << std::endl;
+
+	// Go back and play the same actions again
+	vector<uchar> branch_state;
+	session.GetRewindState(rewind_time, branch_state);
+	start = std::chrono::steady_clock::now();
+	bool rewound = session.Rewind(rewind_time);
+	elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "  rewind:    " << 1000 * elapsed.count() << " ms to go back to frame " << session.GetFrameCount();
+	for (uint f = session.GetFrameCount(); f < num_frames; f++) {
+		session.Act(actions[f]);
+		session.Tick(FRAME_TIME);
+	}
+	vector<uchar> state;
+	StateWriter replay_writer(state);
+	session.SaveState(replay_writer);
+	if (!rewound || state != final_state) std::cout << ", DIFFERS from the first play";
+	std::cout << std::endl;
+
+	// Branch a second session from the same point
+	AsteroidsAgentSession branch;
+	branch.Reset(0);
+	StateReader reader(branch_state);
+	bool restored = branch.RestoreState(reader);
+	std::cout << "  branch:    from frame " << branch.GetFrameCount();
+	for (uint f = branch.GetFrameCount(); f < num_frames; f++) {
+		branch.Act(actions[f]);
+		branch.Tick(FRAME_TIME);
+	}
+	StateWriter branch_writer(state);
+	branch.SaveState(branch_writer);
+	if (!restored || state != final_state) std::cout << ", DIFFERS from the first play";
+	std::cout << ", score " << branch.GetScore() << ", " << branch.GetLives() << " lives" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	std::cout << "Default kinematics kernel: " << GetKinematicsKernelName(GetKinematicsKernel()) << std::endl;
+	BenchmarkIntegration();
+	BenchmarkHeadless();
+	BenchmarkReplay();
+	BenchmarkRandom();
+	BenchmarkCulling();
+	BenchmarkParallelUpdate();
+	BenchmarkParallelCollisions();
+	BenchmarkWorldRunner();
+	BenchmarkSnapshot();
+	BenchmarkRewind();
+	return 0;
+}
@@ -15,15 +15,49 @@ public:
 	bool CollisionTest(shared_ptr<BoundingShape> bs) {
 		if (GetType() == bs->GetType()) {
 			BoundingSphere* bsphere = (BoundingSphere*)bs.get();
-			GLVector3f pos1 = GetGameObject()->GetPosition();
-			GLVector3f pos2 = bsphere->GetGameObject()->GetPosition();
-			float distanceSqr = (pos2 - pos1).lengthSqr();
+			shared_ptr<GameObject> object1 = GetGameObject();
+			shared_ptr<GameObject> object2 = bsphere->GetGameObject();
 			float collision_distance = GetRadius() + bsphere->GetRadius();
+			if (object1->IsFastMover() || object2->IsFastMover()) {
+				return SweptCollisionTest(object1, object2, collision_distance);
+			}
+			GLVector3f pos1 = object1->GetPosition();
+			GLVector3f pos2 = object2->GetPosition();
+			float distanceSqr = (pos2 - pos1).lengthSqr();
 			return (distanceSqr <= pow(collision_distance, 2));
 		}
 		return false;
 	}
 
+	/** Test whether two objects came within a distance of each other at any point
+		during the last step, assuming each moved in a straight line from its
+		previous position to its current one. */
+	static bool SweptCollisionTest(shared_ptr<GameObject> o1, shared_ptr<GameObject> o2, float collision_distance) {
+		// Motion of each object, and where the first started relative to the second,
+		// the short way round if they wrapped or are on opposite edges of the world
+		GLVector3f motion1 = o1->GetPosition() - o1->GetPreviousPosition();
+		GLVector3f motion2 = o2->GetPosition() - o2->GetPreviousPosition();
+		GLVector3f start = o1->GetPreviousPosition() - o2->GetPreviousPosition();
+		GameWorld* world = o1->GetWorld();
+		if (world) {
+			world->WrapOffset(motion1.x, motion1.y);
+			world->WrapOffset(motion2.x, motion2.y);
+			world->WrapOffset(start.x, start.y);
+		}
+		// Sweep the first object relative to the second, which is then at rest
+		GLVector3f motion = motion1 - motion2;
+		// Find the point of the segment closest to the second object
+		float motionSqr = motion.lengthSqr();
+		float t = 0;
+		if (motionSqr > 0) {
+			t = -start.dot(motion) / motionSqr;
+			if (t < 0) t = 0;
+			if (t > 1) t = 1;
+		}
+		GLVector3f closest = start + motion * t;
+		return (closest.lengthSqr() <= pow(collision_distance, 2));
+	}
+
 	void SetRadius(float r) { mRadius = r; }
 	float GetRadius() { return mRadius; }
 
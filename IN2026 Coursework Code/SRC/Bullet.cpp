@@ -1,25 +1,35 @@
 #include "GameWorld.h"
 #include "Bullet.h"
 #include "BoundingSphere.h"
+#include "CollisionLayers.h"
+#include "ObjectTypes.h"
+#include "StateStream.h"
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
 /** Constructor. Bullets live for 2s by default. */
 Bullet::Bullet()
-	: GameObject("Bullet"), mTimeToLive(2000)
+	: GameObject("Bullet"), mTimeToLive(2000), mPoolSlot(-1)
 {
+	mCollisionLayer = COLLISION_LAYER_BULLET;
+	mCollisionMask = COLLISION_LAYER_ASTEROID;
+	mFastMover = true;
 }
 
 /** Construct a new bullet with given position, velocity, acceleration, angle, rotation and lifespan. */
 Bullet::Bullet(GLVector3f p, GLVector3f v, GLVector3f a, GLfloat h, GLfloat r, int ttl)
-	: GameObject("Bullet", p, v, a, h, r), mTimeToLive(ttl)
+	: GameObject("Bullet", p, v, a, h, r), mTimeToLive(ttl), mPoolSlot(-1)
 {
+	mCollisionLayer = COLLISION_LAYER_BULLET;
+	mCollisionMask = COLLISION_LAYER_ASTEROID;
+	mFastMover = true;
 }
 
 /** Copy constructor. */
 Bullet::Bullet(const Bullet& b)
 	: GameObject(b),
-	  mTimeToLive(b.mTimeToLive)
+	  mTimeToLive(b.mTimeToLive),
+	  mPoolSlot(-1)
 {
 }
 
@@ -48,13 +58,27 @@ void Bullet::Update(int t)
 
 bool Bullet::CollisionTest(shared_ptr<GameObject> o)
 {
-	if (o->GetType() != GameObjectType("Asteroid")) return false;
+	if (o->GetType() != ASTEROID_TYPE) return false;
 	if (mBoundingShape.get() == NULL) return false;
 	if (o->GetBoundingShape().get() == NULL) return false;
 	return mBoundingShape->CollisionTest(o->GetBoundingShape());
 }
 
-void Bullet::OnCollision(const GameObjectList& objects)
+void Bullet::OnCollision(const GameObjectSpan& objects)
 {
 	mWorld->FlagForRemoval(GetThisPtr());
 }
+
+/** Save the bullet's state, including how long it has left to live. */
+void Bullet::SaveState(StateWriter& writer)
+{
+	GameObject::SaveState(writer);
+	writer.Write(mTimeToLive);
+}
+
+/** Restore the state saved by SaveState. */
+void Bullet::RestoreState(StateReader& reader)
+{
+	GameObject::RestoreState(reader);
+	reader.Read(mTimeToLive);
+}
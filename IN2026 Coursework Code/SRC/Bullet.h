@@ -17,11 +17,19 @@ public:
 	void SetTimeToLive(int ttl) { mTimeToLive = ttl; }
 	int GetTimeToLive(void) { return mTimeToLive; }
 
+	void SetPoolSlot(int slot) { mPoolSlot = slot; }
+	int GetPoolSlot(void) { return mPoolSlot; }
+
 	bool CollisionTest(shared_ptr<GameObject> o);
-	void OnCollision(const GameObjectList& objects);
+	void OnCollision(const GameObjectSpan& objects);
+
+	void SaveState(StateWriter& writer);
+	void RestoreState(StateReader& reader);
 
 protected:
 	int mTimeToLive;
+	// Slot of this bullet in the pool that owns it, or -1 if it is not pooled
+	int mPoolSlot;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "GameUtil.h"
+#include "GameObject.h"
+#include "Bullet.h"
+#include "BulletPool.h"
+#include "BoundingSphere.h"
+#include "ObjectTypes.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Constructor. Constructs capacity bullets up front so the first shots do not allocate. */
+BulletPool::BulletPool(uint capacity)
+	: mHighWaterMark(0),
+	  mNumMisses(0)
+{
+	Reserve(capacity);
+}
+
+/** Destructor. */
+BulletPool::~BulletPool(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Construct bullets until the pool holds at least capacity of them. */
+void BulletPool::Reserve(uint capacity)
+{
+	while (mBullets.size() < capacity) {
+		mFreeSlots.push_back(CreateBullet());
+	}
+}
+
+/** Get a bullet that is not in a world and set it up as if newly constructed
+	with the given position, velocity, acceleration, angle and lifespan. */
+shared_ptr<Bullet> BulletPool::Acquire(GLVector3f p, GLVector3f v, GLVector3f a, GLfloat h, int ttl)
+{
+	uint slot;
+	if (mFreeSlots.empty()) {
+		// Every bullet is in use, so the pool has to grow
+		slot = CreateBullet();
+		mNumMisses++;
+	} else {
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	mInUse[slot] = true;
+	if (GetNumInUse() > mHighWaterMark) mHighWaterMark = GetNumInUse();
+
+	shared_ptr<Bullet>& bullet = mBullets[slot];
+	bullet->SetPosition(p);
+	bullet->SetVelocity(v);
+	bullet->SetAcceleration(a);
+	bullet->SetAngle(h);
+	bullet->SetRotation(0);
+	bullet->SetTimeToLive(ttl);
+	return bullet;
+}
+
+/** Return pooled bullets to the pool when they leave a world, whether their time
+	to live has expired or they have hit something. */
+void BulletPool::OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
+{
+	if (object->GetType() != BULLET_TYPE) return;
+	int slot = ((Bullet*)object.get())->GetPoolSlot();
+	if (slot < 0 || (uint)slot >= mBullets.size()) return;
+	if (mBullets[slot] != object) return;
+	// Objects flagged for removal twice in a frame are reported removed twice
+	if (!mInUse[slot]) return;
+	mInUse[slot] = false;
+	mFreeSlots.push_back((uint)slot);
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Construct a bullet and its bounding sphere, returning its slot. */
+uint BulletPool::CreateBullet()
+{
+	uint slot = (uint)mBullets.size();
+	shared_ptr<Bullet> bullet = make_shared<Bullet>();
+	bullet->SetBoundingShape(make_shared<BoundingSphere>(bullet->GetThisPtr(), 2.0f));
+	bullet->SetPoolSlot((int)slot);
+	mBullets.push_back(bullet);
+	mInUse.push_back(false);
+	return slot;
+}
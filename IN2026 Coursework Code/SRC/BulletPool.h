@@ -0,0 +1,44 @@
+#ifndef __BULLETPOOL_H__
+#define __BULLETPOOL_H__
+
+#include "GameUtil.h"
+#include "IGameWorldListener.h"
+#include <vector>
+
+class Bullet;
+
+class BulletPool : public IGameWorldListener
+{
+public:
+	BulletPool(uint capacity = 0);
+	virtual ~BulletPool(void);
+
+	void Reserve(uint capacity);
+	shared_ptr<Bullet> Acquire(GLVector3f p, GLVector3f v, GLVector3f a, GLfloat h, int ttl);
+
+	void OnWorldUpdated(GameWorld* world) {}
+	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object) {}
+	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object);
+
+	uint GetNumBullets() const { return (uint)mBullets.size(); }
+	uint GetNumInUse() const { return (uint)(mBullets.size() - mFreeSlots.size()); }
+	uint GetHighWaterMark() const { return mHighWaterMark; }
+	uint GetNumMisses() const { return mNumMisses; }
+
+protected:
+	uint CreateBullet();
+
+	// Every bullet the pool has constructed, each with its bounding sphere
+	vector< shared_ptr<Bullet> > mBullets;
+	// Slots of bullets that are not in a world and can be reused
+	vector< uint > mFreeSlots;
+	// Whether the bullet in each slot has been handed out and not yet removed
+	vector< bool > mInUse;
+
+	// Most bullets that have been in use at once
+	uint mHighWaterMark;
+	// Number of times a bullet was constructed because none were free
+	uint mNumMisses;
+};
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef __COLLISIONLAYERS_H__
+#define __COLLISIONLAYERS_H__
+
+#include "GameUtil.h"
+
+// Collision layers of the objects in an asteroids game
+const uint COLLISION_LAYER_ASTEROID = 1 << 1;
+const uint COLLISION_LAYER_BULLET = 1 << 2;
+const uint COLLISION_LAYER_SPACESHIP = 1 << 3;
+const uint COLLISION_LAYER_EXPLOSION = 1 << 4;
+
+#endif
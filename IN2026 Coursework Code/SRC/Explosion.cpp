@@ -1,18 +1,27 @@
 #include "GameWorld.h"
 #include "BoundingSphere.h"
 #include "Explosion.h"
+#include "CollisionLayers.h"
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
-/** Constructor. */
-Explosion::Explosion() : GameObject("Explosion") {}
+/** Constructor. Explosions never collide with anything. */
+Explosion::Explosion() : GameObject("Explosion"), mPoolSlot(-1)
+{
+	mCollisionLayer = COLLISION_LAYER_EXPLOSION;
+	mCollisionMask = 0;
+}
 
 /** Construct a new explosion with given position, velocity, angle and rotation. */
 Explosion::Explosion(GLVector3f p, GLVector3f v, GLfloat h, GLfloat r)
-: GameObject("Explosion", p, v, GLVector3f(), h, r) {}
+: GameObject("Explosion", p, v, GLVector3f(), h, r), mPoolSlot(-1)
+{
+	mCollisionLayer = COLLISION_LAYER_EXPLOSION;
+	mCollisionMask = 0;
+}
 
 /** Copy constructor. */
-Explosion::Explosion(const Explosion& e) : GameObject(e) {}
+Explosion::Explosion(const Explosion& e) : GameObject(e), mPoolSlot(-1) {}
 
 /** Destructor. */
 Explosion::~Explosion(void) {}
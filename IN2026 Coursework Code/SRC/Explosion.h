@@ -13,6 +13,13 @@ public:
 	virtual ~Explosion(void);
 
 	virtual void Update(int t);
+
+	void SetPoolSlot(int slot) { mPoolSlot = slot; }
+	int GetPoolSlot(void) { return mPoolSlot; }
+
+protected:
+	// Slot of this explosion in the pool that owns it, or -1 if it is not pooled
+	int mPoolSlot;
 };
 
 #endif
@@ -0,0 +1,84 @@
+#include "GameUtil.h"
+#include "GameObject.h"
+#include "Animation.h"
+#include "Explosion.h"
+#include "ExplosionPool.h"
+#include "Sprite.h"
+#include "ObjectTypes.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Constructor. Explosions cannot be constructed until an animation has been set. */
+ExplosionPool::ExplosionPool(void)
+	: mAnimation(NULL),
+	  mHighWaterMark(0),
+	  mNumMisses(0)
+{
+}
+
+/** Destructor. */
+ExplosionPool::~ExplosionPool(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Construct explosions until the pool holds at least capacity of them. */
+void ExplosionPool::Reserve(uint capacity)
+{
+	while (mExplosions.size() < capacity) {
+		mFreeSlots.push_back(CreateExplosion());
+	}
+}
+
+/** Get an explosion that is not in a world, at the centre of the world and with
+	its sprite rewound to the first frame. */
+shared_ptr<Explosion> ExplosionPool::Acquire(void)
+{
+	uint slot;
+	if (mFreeSlots.empty()) {
+		// Every explosion is in use, so the pool has to grow
+		slot = CreateExplosion();
+		mNumMisses++;
+	} else {
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	mInUse[slot] = true;
+	if (GetNumInUse() > mHighWaterMark) mHighWaterMark = GetNumInUse();
+
+	mSprites[slot]->Rewind();
+	shared_ptr<Explosion>& explosion = mExplosions[slot];
+	explosion->Reset();
+	return explosion;
+}
+
+/** Return pooled explosions to the pool when they leave a world. */
+void ExplosionPool::OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
+{
+	if (object->GetType() != EXPLOSION_TYPE) return;
+	int slot = ((Explosion*)object.get())->GetPoolSlot();
+	if (slot < 0 || (uint)slot >= mExplosions.size()) return;
+	if (mExplosions[slot] != object) return;
+	// Objects flagged for removal twice in a frame are reported removed twice
+	if (!mInUse[slot]) return;
+	mInUse[slot] = false;
+	mFreeSlots.push_back((uint)slot);
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Construct an explosion and its sprite, returning its slot. */
+uint ExplosionPool::CreateExplosion()
+{
+	uint slot = (uint)mExplosions.size();
+	shared_ptr<Sprite> sprite = make_shared<Sprite>(mAnimation->GetWidth(), mAnimation->GetHeight(), mAnimation);
+	sprite->SetLoopAnimation(false);
+	shared_ptr<Explosion> explosion = make_shared<Explosion>();
+	explosion->SetSprite(sprite);
+	explosion->SetPoolSlot((int)slot);
+	mExplosions.push_back(explosion);
+	mSprites.push_back(sprite);
+	mInUse.push_back(false);
+	return slot;
+}
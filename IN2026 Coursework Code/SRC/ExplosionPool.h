@@ -0,0 +1,53 @@
+#ifndef __EXPLOSIONPOOL_H__
+#define __EXPLOSIONPOOL_H__
+
+#include "GameUtil.h"
+#include "IGameWorldListener.h"
+#include <vector>
+
+class Animation;
+class Explosion;
+class Sprite;
+
+class ExplosionPool : public IGameWorldListener
+{
+public:
+	ExplosionPool(void);
+	virtual ~ExplosionPool(void);
+
+	void SetAnimation(Animation* animation) { mAnimation = animation; }
+	Animation* GetAnimation() { return mAnimation; }
+
+	void Reserve(uint capacity);
+	shared_ptr<Explosion> Acquire(void);
+
+	void OnWorldUpdated(GameWorld* world) {}
+	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object) {}
+	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object);
+
+	uint GetNumExplosions() const { return (uint)mExplosions.size(); }
+	uint GetNumInUse() const { return (uint)(mExplosions.size() - mFreeSlots.size()); }
+	uint GetHighWaterMark() const { return mHighWaterMark; }
+	uint GetNumMisses() const { return mNumMisses; }
+
+protected:
+	uint CreateExplosion();
+
+	// Animation played by every explosion
+	Animation* mAnimation;
+
+	// Every explosion the pool has constructed and the sprite each one plays
+	vector< shared_ptr<Explosion> > mExplosions;
+	vector< shared_ptr<Sprite> > mSprites;
+	// Slots of explosions that are not in a world and can be reused
+	vector< uint > mFreeSlots;
+	// Whether the explosion in each slot has been handed out and not yet removed
+	vector< bool > mInUse;
+
+	// Most explosions that have been in use at once
+	uint mHighWaterMark;
+	// Number of times an explosion was constructed because none were free
+	uint mNumMisses;
+};
+
+#endif
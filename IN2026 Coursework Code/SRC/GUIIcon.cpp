@@ -1,5 +1,6 @@
 #include "Image.h"
 #include "GUIIcon.h"
+#include "RenderState.h"
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
@@ -27,6 +28,8 @@ void GUIIcon::Draw()
 {
 	if (!mVisible) return;
 	if (mImage == NULL) return;
+	// Pixels drawn with texturing enabled would be textured
+	RenderState::GetInstance().SetTexturing(false);
 	glAlphaFunc(GL_GEQUAL, 0.5);
 	glEnable(GL_ALPHA_TEST);
 	glDrawBuffer(GL_BACK);
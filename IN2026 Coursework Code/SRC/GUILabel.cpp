@@ -1,5 +1,6 @@
 #include <string>
 #include "GUILabel.h"
+#include "RenderState.h"
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
@@ -42,11 +43,12 @@ void GUILabel::Draw()
 		align_y = -h/2;
 	}
 
-	glDisable(GL_LIGHTING);
-	glColor3f(mColor[0], mColor[1], mColor[2]);
+	RenderState& state = RenderState::GetInstance();
+	state.SetLighting(false);
+	state.SetTexturing(false);
+	state.SetColour(mColor[0], mColor[1], mColor[2]);
 	glRasterPos2i(mPosition.x + mBorder.x + align_x, mPosition.y + mBorder.y + align_y);
 	for (uint i = 0; i < mText.length(); ++i) {
 		glutBitmapCharacter(GLUT_BITMAP_9_BY_15, mText[i]);
 	}
-	glEnable(GL_LIGHTING);
 }
@@ -1,5 +1,6 @@
 #include "GameWorld.h"
 #include "GameObject.h"
+#include "StateStream.h"
 
 bool GameObject::mRenderDebug = false;
 
@@ -9,12 +10,20 @@ bool GameObject::mRenderDebug = false;
 GameObject::GameObject(char const * const type_name)
 	: mType(type_name),
 	  mWorld(NULL),
+	  mWorldIndex(0),
 	  mPosition(0,0,0),
 	  mVelocity(0,0,0),
 	  mAcceleration(0,0,0),
 	  mAngle(0),
 	  mRotation(0),
-	  mScale(1)
+	  mScale(1),
+	  mPreviousPosition(0,0,0),
+	  mPreviousAngle(0),
+	  mFastMover(false),
+	  mKinematics(NULL),
+	  mKinematicsSlot(0),
+	  mCollisionLayer(COLLISION_LAYER_DEFAULT),
+	  mCollisionMask(COLLISION_MASK_ALL)
 {
 }
 
@@ -22,31 +31,48 @@ GameObject::GameObject(char const * const type_name)
 GameObject::GameObject(char const * const type_name, GLVector3f p, GLVector3f v, GLVector3f a, GLfloat h, GLfloat r)
 	: mType(type_name),
 	  mWorld(NULL),
+	  mWorldIndex(0),
 	  mPosition(p),
 	  mVelocity(v),
 	  mAcceleration(a),
 	  mAngle(h),
 	  mRotation(r),
-	  mScale(1)
+	  mScale(1),
+	  mPreviousPosition(p),
+	  mPreviousAngle(h),
+	  mFastMover(false),
+	  mKinematics(NULL),
+	  mKinematicsSlot(0),
+	  mCollisionLayer(COLLISION_LAYER_DEFAULT),
+	  mCollisionMask(COLLISION_MASK_ALL)
 {
 }
 
 /** Copy constructor. */
 GameObject::GameObject(const GameObject& o)
-	: mType(o.mType.GetTypeName()),
+	: mType(o.mType),
 	  mWorld(o.mWorld),
-	  mPosition(o.mPosition),
-	  mVelocity(o.mVelocity),
-	  mAcceleration(o.mAcceleration),
-	  mAngle(o.mAngle),
-	  mRotation(o.mRotation),
-	  mScale(o.mScale)
+	  mWorldIndex(o.mWorldIndex),
+	  mPosition(o.GetPosition()),
+	  mVelocity(o.GetVelocity()),
+	  mAcceleration(o.GetAcceleration()),
+	  mAngle(o.GetAngle()),
+	  mRotation(o.GetRotation()),
+	  mScale(o.mScale),
+	  mPreviousPosition(o.mPreviousPosition),
+	  mPreviousAngle(o.mPreviousAngle),
+	  mFastMover(o.mFastMover),
+	  mKinematics(NULL),
+	  mKinematicsSlot(0),
+	  mCollisionLayer(o.mCollisionLayer),
+	  mCollisionMask(o.mCollisionMask)
 {
 }
 
 /** Destructor. */
 GameObject::~GameObject(void)
 {
+	DetachKinematics();
 }
 
 // PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
@@ -64,29 +90,88 @@ void GameObject::Reset()
 /** Update this game object by updating position, velocity and angle of object. */
 void GameObject::Update(int t)
 {
-	// Calculate seconds since last update
-	float dt = t / 1000.0f;
-	// Update angle
-	AddAngle(mRotation * dt);
-	// Update position
-	AddPosition(mVelocity * dt);
-	// Update velocity
-	AddVelocity(mAcceleration * dt);
+	// Bodies in a kinematics store are integrated and wrapped by their world
+	if (mKinematics == NULL) {
+		// Calculate seconds since last update
+		float dt = t / 1000.0f;
+		// Update angle
+		AddAngle(mRotation * dt);
+		// Update position
+		AddPosition(mVelocity * dt);
+		// Update velocity
+		AddVelocity(mAcceleration * dt);
+		// If in world, wrap position
+		if (mWorld) { mWorld->WrapXY(mPosition.x, mPosition.y); }
+	}
 	// Update sprite if one exists
 	if (mSprite.get() != NULL) mSprite->Update(t);
-	// If in world, wrap position
-	if (mWorld) { mWorld->WrapXY(mPosition.x, mPosition.y); }
 }
 
-/** Set up rendering system ready to render object. */
-void GameObject::PreRender(void)
+/** Move kinematic state into a store, after which this object is a handle to its slot. */
+void GameObject::AttachKinematics(KinematicsStore* store)
+{
+	if (mKinematics == store) return;
+	DetachKinematics();
+	if (store == NULL) return;
+	mKinematicsSlot = store->Add(mPosition, mVelocity, mAcceleration, mAngle, mRotation);
+	store->PreviousPosition(mKinematicsSlot) = mPreviousPosition;
+	store->PreviousAngle(mKinematicsSlot) = mPreviousAngle;
+	mKinematics = store;
+}
+
+/** Copy kinematic state back out of the store and release its slot. */
+void GameObject::DetachKinematics()
+{
+	if (mKinematics == NULL) return;
+	mPosition = mKinematics->Position(mKinematicsSlot);
+	mVelocity = mKinematics->Velocity(mKinematicsSlot);
+	mAcceleration = mKinematics->Acceleration(mKinematicsSlot);
+	mAngle = mKinematics->Angle(mKinematicsSlot);
+	mRotation = mKinematics->Rotation(mKinematicsSlot);
+	mPreviousPosition = mKinematics->PreviousPosition(mKinematicsSlot);
+	mPreviousAngle = mKinematics->PreviousAngle(mKinematicsSlot);
+	mKinematics->Remove(mKinematicsSlot);
+	mKinematics = NULL;
+}
+
+/** Get the position to render at, alpha of the way from the previous tick to the current one. */
+GLVector3f GameObject::GetRenderPosition(float alpha) const
+{
+	const GLVector3f& position = PositionRef();
+	if (alpha >= 1.0f) return position;
+	const GLVector3f& previous = PreviousPositionRef();
+	GLVector3f delta = position - previous;
+	// Objects that wrapped around the world jump rather than sweep across it
+	if (mWorld && (fabs(delta.x) > mWorld->GetWidth() / 2 || fabs(delta.y) > mWorld->GetHeight() / 2)) {
+		return position;
+	}
+	return previous + delta * alpha;
+}
+
+/** Get the angle to render at, alpha of the way from the previous tick to the current one. */
+GLfloat GameObject::GetRenderAngle(float alpha) const
+{
+	GLfloat angle = AngleRef();
+	if (alpha >= 1.0f) return angle;
+	// Turn the short way round when the angle crosses 0/360
+	GLfloat previous = PreviousAngleRef();
+	GLfloat delta = angle - previous;
+	if (delta > 180) delta -= 360;
+	if (delta < -180) delta += 360;
+	return previous + delta * alpha;
+}
+
+/** Set up rendering system ready to render object, alpha of the way from its
+	state before the last fixed tick to its current state. */
+void GameObject::PreRender(float alpha)
 {
 	// Push current transformation matrix onto stack
 	glPushMatrix();
 	// Translate drawing position to ship's position
-	glTranslatef(mPosition.x, mPosition.y, mPosition.z);
+	GLVector3f position = GetRenderPosition(alpha);
+	glTranslatef(position.x, position.y, position.z);
 	// Rotate drawing around Z-axis to ship's angle
-	glRotatef(mAngle,0,0,1);
+	glRotatef(GetRenderAngle(alpha),0,0,1);
 	// Scale drawing to scale
 	glScalef(mScale, mScale, mScale);
 }
@@ -103,4 +188,76 @@ void GameObject::PostRender(void)
 {
 	// Restore projection matrix from stack
 	glPopMatrix();
+}
+
+/** Get the radius about the object's position that everything it renders lies
+	within, or a negative value if it is not known and the object is never culled. */
+GLfloat GameObject::GetRenderRadius(void)
+{
+	if (mSprite.get() == NULL && mShape.get() == NULL) return -1;
+	GLfloat radius = 0;
+	if (mSprite.get() != NULL) radius = max(radius, mSprite->GetRadius());
+	if (mShape.get() != NULL) radius = max(radius, mShape->GetRadius());
+	return radius * mScale;
+}
+
+/** Get a key that objects drawn with the same render state share: the texture
+	of the object's sprite, or 0 if it is only drawn with lines. */
+uint GameObject::GetRenderStateKey(void)
+{
+	return (mSprite.get() != NULL) ? mSprite->GetTextureID() : 0;
+}
+
+/** Add this object to a sprite batch instead of rendering it, if all it draws
+	is its sprite or its shape. Returns false if it must be rendered itself. */
+bool GameObject::RenderToBatch(SpriteBatch& batch, float alpha)
+{
+	if ((mSprite.get() == NULL) == (mShape.get() == NULL)) return false;
+	if (mSprite.get() != NULL) mSprite->RenderToBatch(batch, GetRenderPosition(alpha), GetRenderAngle(alpha), mScale);
+	else batch.AddShape(mShape.get(), GetRenderPosition(alpha), GetRenderAngle(alpha), mScale);
+	return true;
+}
+
+/** Save everything about this object that changes as the world runs: its motion,
+	where it was before the last step, its collision layers and its sprite's
+	animation. What it looks like and its bounding shape are left to whoever
+	creates the object, so they are not saved. */
+void GameObject::SaveState(StateWriter& writer)
+{
+	writer.Write(PositionRef());
+	writer.Write(VelocityRef());
+	writer.Write(AccelerationRef());
+	writer.Write(AngleRef());
+	writer.Write(RotationRef());
+	writer.Write(PreviousPositionRef());
+	writer.Write(PreviousAngleRef());
+	writer.Write(mScale);
+	writer.Write(mCollisionLayer);
+	writer.Write(mCollisionMask);
+	writer.Write(mFastMover);
+	uchar has_sprite = (mSprite.get() != NULL) ? 1 : 0;
+	writer.Write(has_sprite);
+	if (has_sprite) mSprite->SaveState(writer);
+}
+
+/** Restore the state saved by SaveState. A saved sprite animation is skipped if
+	the object has no sprite to restore it to. */
+void GameObject::RestoreState(StateReader& reader)
+{
+	reader.Read(PositionRef());
+	reader.Read(VelocityRef());
+	reader.Read(AccelerationRef());
+	reader.Read(AngleRef());
+	reader.Read(RotationRef());
+	reader.Read(PreviousPositionRef());
+	reader.Read(PreviousAngleRef());
+	reader.Read(mScale);
+	reader.Read(mCollisionLayer);
+	reader.Read(mCollisionMask);
+	reader.Read(mFastMover);
+	uchar has_sprite = 0;
+	reader.Read(has_sprite);
+	if (!has_sprite) return;
+	if (mSprite.get() != NULL) mSprite->RestoreState(reader);
+	else Sprite::SkipState(reader);
 }
\ No newline at end of file
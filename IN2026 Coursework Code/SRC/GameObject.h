@@ -4,13 +4,22 @@
 #include "GameObjectType.h"
 #include "GameUtil.h"
 #include "GameWorld.h"
+#include "KinematicsStore.h"
 #include "Shape.h"
 #include "Sprite.h"
 
 class BoundingShape;
+class SpriteBatch;
+class StateWriter;
+class StateReader;
 
 class GameObject : public enable_shared_from_this<GameObject>
 {
+public:
+	// Collision layer of objects that do not set one, and a mask matching every layer
+	static const uint COLLISION_LAYER_DEFAULT = 1;
+	static const uint COLLISION_MASK_ALL = 0xFFFFFFFF;
+
 public:
 	GameObject(char const * const type_name);
 	GameObject(char const * const type_name, GLVector3f p, GLVector3f v, GLVector3f a, GLfloat h, GLfloat r);
@@ -20,35 +29,62 @@ public:
 	void Reset();
 
 	virtual void Update(int t);
-	virtual void PreRender(void);
+	virtual void PreRender(float alpha);
 	virtual void Render(void);
 	virtual void PostRender(void);
+	virtual bool RenderToBatch(SpriteBatch& batch, float alpha);
+	virtual GLfloat GetRenderRadius(void);
+	virtual uint GetRenderStateKey(void);
 	
 	virtual bool CollisionTest(shared_ptr<GameObject> o) { return false; }
-	virtual void OnCollision(const GameObjectList& objects) {}
+	virtual void OnCollision(const GameObjectSpan& objects) {}
+
+	virtual void SaveState(StateWriter& writer);
+	virtual void RestoreState(StateReader& reader);
+
+	void SetCollisionLayer(uint layer) { mCollisionLayer = layer; }
+	uint GetCollisionLayer() const { return mCollisionLayer; }
+	void SetCollisionMask(uint mask) { mCollisionMask = mask; }
+	uint GetCollisionMask() const { return mCollisionMask; }
+	bool CanCollideWith(const GameObject& o) const { return (mCollisionMask & o.mCollisionLayer) != 0; }
 
 	const GameObjectType& GetType() const { return mType; }
 
+	void SetFastMover(bool fast) { mFastMover = fast; }
+	bool IsFastMover() const { return mFastMover; }
+
 	void SetWorld(GameWorld *w) { mWorld = w; }
 	GameWorld* GetWorld() { return mWorld; }
 
-	void SetAngle(GLfloat a) { mAngle = a; }
-	void SetRotation(GLfloat r) { mRotation = r; }
-	void SetPosition(GLVector3f p) { mPosition = p; }
-	void SetVelocity(GLVector3f v) { mVelocity = v; }
-	void SetAcceleration(GLVector3f a) { mAcceleration = a; }
-	
-	void AddAngle(GLfloat a) { mAngle += a; if (mAngle < 0) mAngle += 360; if (mAngle > 360) mAngle -= 360; }
-	void AddRotation(GLfloat r) { mRotation += r; }
-	void AddPosition(GLVector3f p) { mPosition += p; }
-	void AddVelocity(GLVector3f v) { mVelocity += v; }
-	void AddAcceleration(GLVector3f a) { mAcceleration += a; }
-
-	GLfloat GetAngle() { return mAngle; }
-	GLfloat GetRotation() { return mRotation; }
-	GLVector3f GetPosition() { return mPosition; }
-	GLVector3f GetVelocity() { return mVelocity; }
-	GLVector3f GetAcceleration() { return mAcceleration; }
+	void SetWorldIndex(uint i) { mWorldIndex = i; }
+	uint GetWorldIndex() const { return mWorldIndex; }
+
+	void SetAngle(GLfloat a) { AngleRef() = a; }
+	void SetRotation(GLfloat r) { RotationRef() = r; }
+	void SetPosition(GLVector3f p) { PositionRef() = p; }
+	void SetVelocity(GLVector3f v) { VelocityRef() = v; }
+	void SetAcceleration(GLVector3f a) { AccelerationRef() = a; }
+
+	void AddAngle(GLfloat a) { GLfloat& h = AngleRef(); h += a; if (h < 0) h += 360; if (h > 360) h -= 360; }
+	void AddRotation(GLfloat r) { RotationRef() += r; }
+	void AddPosition(GLVector3f p) { PositionRef() += p; }
+	void AddVelocity(GLVector3f v) { VelocityRef() += v; }
+	void AddAcceleration(GLVector3f a) { AccelerationRef() += a; }
+
+	GLfloat GetAngle() const { return AngleRef(); }
+	GLfloat GetRotation() const { return RotationRef(); }
+	GLVector3f GetPosition() const { return PositionRef(); }
+	GLVector3f GetVelocity() const { return VelocityRef(); }
+	GLVector3f GetAcceleration() const { return AccelerationRef(); }
+
+	void StorePreviousState() { PreviousPositionRef() = PositionRef(); PreviousAngleRef() = AngleRef(); }
+	const GLVector3f& GetPreviousPosition() const { return PreviousPositionRef(); }
+	GLVector3f GetRenderPosition(float alpha) const;
+	GLfloat GetRenderAngle(float alpha) const;
+
+	void AttachKinematics(KinematicsStore* store);
+	void DetachKinematics();
+	KinematicsStore* GetKinematics() { return mKinematics; }
 
 	void SetScale(float s) { mScale = s; }
 	float GetScale() { return mScale; }
@@ -61,9 +97,27 @@ public:
 	shared_ptr<GameObject> GetThisPtr() { return shared_from_this(); }
 
 protected:
+	// Kinematic state lives in the store when attached to one, otherwise in this object
+	GLfloat& AngleRef() { return mKinematics ? mKinematics->Angle(mKinematicsSlot) : mAngle; }
+	GLfloat& RotationRef() { return mKinematics ? mKinematics->Rotation(mKinematicsSlot) : mRotation; }
+	GLVector3f& PositionRef() { return mKinematics ? mKinematics->Position(mKinematicsSlot) : mPosition; }
+	GLVector3f& VelocityRef() { return mKinematics ? mKinematics->Velocity(mKinematicsSlot) : mVelocity; }
+	GLVector3f& AccelerationRef() { return mKinematics ? mKinematics->Acceleration(mKinematicsSlot) : mAcceleration; }
+	const GLfloat& AngleRef() const { return mKinematics ? mKinematics->Angle(mKinematicsSlot) : mAngle; }
+	const GLfloat& RotationRef() const { return mKinematics ? mKinematics->Rotation(mKinematicsSlot) : mRotation; }
+	const GLVector3f& PositionRef() const { return mKinematics ? mKinematics->Position(mKinematicsSlot) : mPosition; }
+	const GLVector3f& VelocityRef() const { return mKinematics ? mKinematics->Velocity(mKinematicsSlot) : mVelocity; }
+	const GLVector3f& AccelerationRef() const { return mKinematics ? mKinematics->Acceleration(mKinematicsSlot) : mAcceleration; }
+	GLVector3f& PreviousPositionRef() { return mKinematics ? mKinematics->PreviousPosition(mKinematicsSlot) : mPreviousPosition; }
+	GLfloat& PreviousAngleRef() { return mKinematics ? mKinematics->PreviousAngle(mKinematicsSlot) : mPreviousAngle; }
+	const GLVector3f& PreviousPositionRef() const { return mKinematics ? mKinematics->PreviousPosition(mKinematicsSlot) : mPreviousPosition; }
+	GLfloat PreviousAngleRef() const { return mKinematics ? mKinematics->PreviousAngle(mKinematicsSlot) : mPreviousAngle; }
+
 	GameObjectType mType;
 
 	GameWorld* mWorld;
+	// Index of this object in its world's dense object array
+	uint mWorldIndex;
 	GLVector3f mPosition;
 	GLVector3f mVelocity;
 	GLVector3f mAcceleration;
@@ -71,6 +125,21 @@ protected:
 	GLfloat mRotation;
 	GLfloat mScale;
 
+	// Position and angle before the last step, for sweeping and for rendering between ticks
+	GLVector3f mPreviousPosition;
+	GLfloat mPreviousAngle;
+
+	// Whether collisions are tested along the path moved each step, not just at its end
+	bool mFastMover;
+
+	// Store holding this object's kinematic state, if any, and its slot in the store
+	KinematicsStore* mKinematics;
+	uint mKinematicsSlot;
+
+	// The layer this object is on and the layers it tests for collisions with
+	uint mCollisionLayer;
+	uint mCollisionMask;
+
 	shared_ptr<Shape> mShape;
 	shared_ptr<Sprite> mSprite;
 	shared_ptr<BoundingShape> mBoundingShape;
@@ -0,0 +1,33 @@
+#ifndef __GAMEOBJECTSPAN_H__
+#define __GAMEOBJECTSPAN_H__
+
+#include <cstddef>
+
+class GameObject;
+
+// A view of a contiguous run of game objects owned by someone else, such as the
+// objects colliding with one object. Copying it copies two pointers.
+class GameObjectSpan
+{
+public:
+	typedef GameObject* const* iterator;
+
+	GameObjectSpan() : mBegin(NULL), mEnd(NULL) {}
+	GameObjectSpan(iterator b, iterator e) : mBegin(b), mEnd(e) {}
+
+	iterator begin() const { return mBegin; }
+	iterator end() const { return mEnd; }
+
+	size_t size() const { return (size_t)(mEnd - mBegin); }
+	bool empty() const { return mBegin == mEnd; }
+
+	GameObject* operator[] (size_t i) const { return mBegin[i]; }
+	GameObject* front() const { return *mBegin; }
+	GameObject* back() const { return *(mEnd - 1); }
+
+private:
+	iterator mBegin;
+	iterator mEnd;
+};
+
+#endif
@@ -1,26 +1,78 @@
 #ifndef __GAMEOBJECTTYPE__H__
 #define __GAMEOBJECTTYPE__H__
 
+#include <cstddef>
+
 class GameObjectType
 {
 public:
-	explicit GameObjectType(char const * const pTypeName)
-		: mTypeName(pTypeName), mTypeID(HashName(pTypeName))
+	constexpr explicit GameObjectType(char const * const pTypeName)
+		: mTypeID(HashName(pTypeName)), mTypeName(pTypeName)
 	{}
 
-	unsigned long GetTypeID() const { return mTypeID; }
-	char const * const GetTypeName() const { return mTypeName; }
+	constexpr unsigned long GetTypeID() const { return mTypeID; }
+	constexpr char const * GetTypeName() const { return mTypeName; }
+
+	constexpr bool operator< (GameObjectType const & o) const { return (GetTypeID() < o.GetTypeID()); }
+	constexpr bool operator== (GameObjectType const & o) const { return (GetTypeID() == o.GetTypeID()); }
+	constexpr bool operator!= (GameObjectType const & o) const { return (GetTypeID() != o.GetTypeID()); }
+
+	/** Adler-32 style hash of a type name, usable in constant expressions. Only
+		characters in complete blocks of 16 are lower cased, and the sums are only
+		reduced after a partial block, as existing type IDs depend on both. */
+	static constexpr unsigned long HashName(char const * pTypeName)
+	{
+		// largest prime smaller than 65536
+		const unsigned long BASE = 65521L;
+
+		// NMAX is the largest n such that
+		// 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
+		const unsigned long NMAX = 5552;
+
+		if (pTypeName == nullptr) return 0;
 
-	bool operator< (GameObjectType const & o) const { return (GetTypeID() < o.GetTypeID()); }
-	bool operator== (GameObjectType const & o) const { return (GetTypeID() == o.GetTypeID()); }
-	bool operator!= (GameObjectType const & o) const { return (GetTypeID() != o.GetTypeID()); }
+		unsigned long s1 = 0;
+		unsigned long s2 = 0;
 
-	static unsigned long HashName(char const * const pTypeName);
+		size_t len = 0;
+		while (pTypeName[len] != '\0') len++;
+
+		while (len > 0) {
+			unsigned long k = (len < NMAX) ? len : NMAX;
+			len -= k;
+			while (k >= 16) {
+				for (int i = 0; i < 16; i++) {
+					s1 += ToLower(pTypeName[i]);
+					s2 += s1;
+				}
+				pTypeName += 16;
+				k -= 16;
+			}
+			if (k != 0) {
+				do {
+					s1 += *pTypeName++;
+					s2 += s1;
+				} while (--k);
+
+				s1 %= BASE;
+				s2 %= BASE;
+			}
+		}
+
+		return (s2 << 16) | s1;
+	}
 
 private:
+	static constexpr int ToLower(char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
 
 	unsigned long mTypeID;
 	char const * mTypeName;
 };
 
-#endif
\ No newline at end of file
+/** Construct a type from a string literal, e.g. "Asteroid"_type. */
+constexpr GameObjectType operator"" _type(char const * pTypeName, size_t)
+{
+	return GameObjectType(pTypeName);
+}
+
+#endif
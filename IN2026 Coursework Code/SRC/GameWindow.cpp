@@ -3,6 +3,7 @@
 #include "IKeyboardListener.h"
 #include "GameDisplay.h"
 #include "GameWindow.h"
+#include "RenderState.h"
 
 const int GameWindow::ZOOM_LEVEL = 3;
 
@@ -26,6 +27,8 @@ GameWindow::~GameWindow()
 /** Call world and display to render themselves. */
 void GameWindow::OnDisplay(void)
 {
+	// Start counting render state changes for this frame
+	RenderState::GetInstance().BeginFrame();
 	// Clear the backbuffer
 	glClear(GL_COLOR_BUFFER_BIT);
 	// Render the world and display
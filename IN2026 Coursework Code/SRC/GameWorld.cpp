@@ -1,34 +1,110 @@
+#include <algorithm>
 #include "GameUtil.h"
 #include "GameObject.h"
 #include "GameWorld.h"
+#include "BoundingSphere.h"
+#include "WorldSnapshot.h"
+#include "StateStream.h"
+
+/** Order queued commands by the index of the object that queued them, or
+	runs of contacts by the index of the first candidate pair they were found in. */
+template <class T>
+static bool CompareCommandSource(const pair<uint, T>& a, const pair<uint, T>& b)
+{
+	return a.first < b.first;
+}
+
+thread_local GameWorld::CommandBuffer* GameWorld::mCurrentCommandBuffer = NULL;
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
 /** Default constructor. */
-GameWorld::GameWorld(void) : mWidth(200), mHeight(200)
+GameWorld::GameWorld(void)
+	: mDispatchingCollisions(false),
+	  mCollisionMode(COLLISION_SPATIAL_HASH),
+	  mNarrowphaseChunkSize(1024),
+	  mJobSystem(NULL),
+	  mUpdateChunkSize(256),
+	  mUpdatingInParallel(false),
+	  mKinematicsStoreEnabled(false),
+	  mSpriteBatchingEnabled(false),
+	  mViewSet(false),
+	  mViewX(0),
+	  mViewY(0),
+	  mViewWidth(0),
+	  mViewHeight(0),
+	  mRenderCullingEnabled(false),
+	  mRenderStateSortingEnabled(false),
+	  mFixedTimestepEnabled(false),
+	  mTickRate(60),
+	  mMaxStepsPerUpdate(5),
+	  mAccumulator(0),
+	  mTickCount(0),
+	  mNumDroppedSteps(0),
+	  mInterpolationAlpha(1.0f),
+	  mWidth(200),
+	  mHeight(200)
 {
 }
 
 /** Destructor. */
 GameWorld::~GameWorld(void)
 {
+	// Objects may outlive the world, so give them back their kinematic state
+	SetKinematicsStoreEnabled(false);
 }
 
 // PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
 
-/** Update the world. */
+/** Update the world. With a fixed timestep, t is added to the time still to be
+	simulated and the world advances by as many whole ticks as that covers. */
 void GameWorld::Update(int t)
 {
+	if (!mFixedTimestepEnabled) {
+		Step(t);
+		return;
+	}
+
+	// Accumulate time in thousandths of a tick, so no fraction of a millisecond is lost
+	mAccumulator += (unsigned long long)t * mTickRate;
+	uint steps = 0;
+	while (mAccumulator >= 1000) {
+		// After a long hitch, drop whole ticks rather than spiral further behind
+		if (steps == mMaxStepsPerUpdate) {
+			mNumDroppedSteps += (uint)(mAccumulator / 1000);
+			mAccumulator %= 1000;
+			break;
+		}
+		// Count the tick first, so listeners see the number of ticks completed.
+		// Tick lengths are whole milliseconds that add up to exactly 1000 per second
+		unsigned long long tick = mTickCount++;
+		mAccumulator -= 1000;
+		Step(GetTickLength(tick));
+		steps++;
+	}
+	mInterpolationAlpha = mAccumulator / 1000.0f;
+}
+
+/** Advance the world by t milliseconds. */
+void GameWorld::Step(int t)
+{
+	// Keep where every object was, to sweep fast movers from and to render
+	// between ticks. Every object is in the store when it is enabled
+	if (mKinematicsStoreEnabled) {
+		mKinematicsStore.StorePreviousState();
+	} else {
+		for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+			(*it)->StorePreviousState();
+		}
+	}
 	UpdateObjects(t);
 	UpdateCollisions(t);
 
-	// Remove objects flagged for removal
-	WeakGameObjectList::iterator it = mGameObjectsToRemove.begin();
-	while( it != mGameObjectsToRemove.end() )
-	{
-		RemoveObject(it->lock());
-		it = mGameObjectsToRemove.erase( it );
+	// Remove objects flagged for removal, including any flagged by removal listeners
+	for (size_t i = 0; i < mGameObjectsToRemove.size(); i++) {
+		RemoveObject(mGameObjectsToRemove[i].lock());
 	}
+	mGameObjectsToRemove.clear();
 
 	// Send update message to listeners
 	FireWorldUpdated();
@@ -43,30 +119,77 @@ void GameWorld::Render(void)
 	glPushMatrix();
 	// Initialize the projection matrix to the identity matrix
 	glLoadIdentity();
-	// Set orthographic projection to include the world
-	glOrtho(-mWidth/2, mWidth/2, -mHeight/2, mHeight/2, -100, 100);
+	// Set orthographic projection to include the view, or the whole world
+	float left, bottom, right, top;
+	GetViewBounds(left, bottom, right, top);
+	glOrtho(left, right, bottom, top, -100, 100);
 
 	// Switch to model mode ready for rendering
 	glMatrixMode(GL_MODELVIEW);
 	// Initialize the projection matrix to the identity matrix
 	glLoadIdentity();
-	// Render every object in the world
-	for (GameObjectList::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
-		(*it)->PreRender();
-		(*it)->Render();
-		(*it)->PostRender();
+	// Render every object in the world, batching sprites to draw after the rest
+	float alpha = mFixedTimestepEnabled ? mInterpolationAlpha : 1.0f;
+	if (mSpriteBatchingEnabled) mSpriteBatch.Begin();
+	if (mRenderCullingEnabled || mRenderStateSortingEnabled) {
+		// Only render objects that can be seen, found before making any GL calls
+		if (mRenderCullingEnabled) {
+			CullObjects(alpha, left, bottom, right, top);
+		} else {
+			mRenderOrder.resize(mGameObjects.size());
+			for (uint i = 0; i < mRenderOrder.size(); i++) mRenderOrder[i] = i;
+		}
+		// Draw objects that share render state one after another
+		if (mRenderStateSortingEnabled) SortByRenderState();
+		for (vector<uint>::iterator it = mRenderOrder.begin(); it != mRenderOrder.end(); ++it) {
+			RenderObject(mGameObjects[*it].get(), alpha);
+		}
+	} else {
+		for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+			RenderObject(it->get(), alpha);
+		}
 	}
+	if (mSpriteBatchingEnabled) mSpriteBatch.End();
+}
+
+/** Show the given area of the world, centred on (x, y), instead of all of it. */
+void GameWorld::SetView(float x, float y, float w, float h)
+{
+	mViewSet = true;
+	mViewX = x;
+	mViewY = y;
+	mViewWidth = w;
+	mViewHeight = h;
+}
+
+/** Get the edges of the area of the world shown when rendering. */
+void GameWorld::GetViewBounds(float &left, float &bottom, float &right, float &top)
+{
+	if (!mViewSet) {
+		left = (float)(-mWidth/2);
+		right = (float)(mWidth/2);
+		bottom = (float)(-mHeight/2);
+		top = (float)(mHeight/2);
+		return;
+	}
+	left = mViewX - mViewWidth / 2;
+	right = mViewX + mViewWidth / 2;
+	bottom = mViewY - mViewHeight / 2;
+	top = mViewY + mViewHeight / 2;
 }
 
 /** Add a game object to the world. */
 void GameWorld::AddObject(shared_ptr<GameObject> ptr)
 {
-	// Add game object
-	mGameObjects.push_back(ptr);
-	// Add game object to collision map
-	mCollisions[ptr] = GameObjectList();
-	// Add reference to this world
-	ptr->SetWorld(this);
+	// Objects updating on other threads have to wait to add objects
+	CommandBuffer* buffer = GetCurrentCommandBuffer();
+	if (buffer) {
+		buffer->additions.push_back(make_pair(buffer->source, ptr));
+		return;
+	}
+	// Objects can only be in the world once
+	if (IsInWorld(ptr.get())) return;
+	InsertObject(ptr);
 	// Send message to all listeners
 	FireObjectAdded(ptr);
 }
@@ -74,12 +197,20 @@ void GameWorld::AddObject(shared_ptr<GameObject> ptr)
 /** Remove a game object from the world. */
 void GameWorld::RemoveObject(GameObject* ptr)
 {
-	RemoveObject(shared_ptr<GameObject>(ptr));
+	// Find the shared pointer the world holds rather than making a second owner
+	if (!IsInWorld(ptr)) return;
+	RemoveObject(mGameObjects[ptr->GetWorldIndex()]);
 }
 
 /** Flags an object for removal so it can be removed after all objects have been updated */
 void GameWorld::FlagForRemoval(weak_ptr<GameObject> ptr)
 {
+	// Objects updating on other threads have to wait to flag objects
+	CommandBuffer* buffer = GetCurrentCommandBuffer();
+	if (buffer) {
+		buffer->removals.push_back(make_pair(buffer->source, ptr));
+		return;
+	}
 	// Add it to the list of objects to remove
 	mGameObjectsToRemove.push_back(ptr);
 }
@@ -89,12 +220,34 @@ void GameWorld::RemoveObject(shared_ptr<GameObject> ptr)
 {
 	// Check if we the pointer has already been deleted
 	if(ptr.get() == nullptr) return;
-	// Remove the game object from the list
-	mGameObjects.remove(ptr);
-	// Remove game object from collision map
-	mCollisions.erase(ptr);
+	// Objects flagged twice have already gone by the second removal
+	if (!IsInWorld(ptr.get())) return;
+	// Removing an object while collisions are being handled would free it while
+	// its pointer is still in the runs of objects not yet called
+	if (mDispatchingCollisions) {
+		mDeferredRemovals.push_back(ptr);
+		return;
+	}
+	// Move the last game object into the removed one's place
+	uint index = ptr->GetWorldIndex();
+	uint last = (uint)mGameObjects.size() - 1;
+	if (index != last) {
+		mGameObjects[index].swap(mGameObjects[last]);
+		mGameObjects[index]->SetWorldIndex(index);
+	}
+	// Move the contact run of the last object along with it
+	if (index < mContactRunsByIndex.size()) {
+		ContactRun none = { NULL, 0, 0, 0 };
+		mContactRunsByIndex[index] = (last < mContactRunsByIndex.size()) ? mContactRunsByIndex[last] : none;
+		if (last < mContactRunsByIndex.size()) mContactRunsByIndex[last] = none;
+	}
+	// Remove the game object from the end of the array.
+	// The world's reference goes last, so ptr keeps the object alive.
+	mGameObjects.pop_back();
 	// Remove reference to this world
 	ptr->SetWorld(NULL);
+	// Take kinematic state back out of the store
+	ptr->DetachKinematics();
 	// Send message to all listeners
 	FireObjectRemoved(ptr);
 }
@@ -127,76 +280,138 @@ void GameWorld::FireObjectRemoved(shared_ptr<GameObject> ptr)
 }
 
 /** Get all the collisions for a given object. */
-GameObjectList GameWorld::GetCollisions(shared_ptr<GameObject> ptr)
+GameObjectSpan GameWorld::GetCollisions(shared_ptr<GameObject> ptr)
 {
-	// Find the named game object
-	CollisionMap::iterator it = mCollisions.find(ptr);
-	// If object does not exist return empty list
-	if (it == mCollisions.end()) {
-		mCollisions[ptr] = GameObjectList();
-		CollisionMap::iterator it2 = mCollisions.find(ptr);
-		return it2->second;
-	}
-	// Otherwise return list from collision map
-	return it->second;
+	return GetCollisions(ptr.get());
 }
 
-/** Get all the collisions for a given object. */
-GameObjectList GameWorld::GetCollisions(GameObject* optr)
+/** Get all the collisions for a given object found by the last update. The
+	span points into the world's contact buffer and is valid until the next update. */
+GameObjectSpan GameWorld::GetCollisions(GameObject* optr)
+{
+	// Only objects with collisions have a run in the contact buffer
+	if (optr == NULL) return GameObjectSpan();
+	uint index = optr->GetWorldIndex();
+	if (index >= mContactRunsByIndex.size()) return GameObjectSpan();
+	const ContactRun& run = mContactRunsByIndex[index];
+	if (run.object != optr || run.begin == run.end) return GameObjectSpan();
+	GameObject* const* buffer = &mContactBuffer[0];
+	return GameObjectSpan(buffer + run.begin, buffer + run.end);
+}
+
+/** Put an object at the end of the world's array, without telling listeners. */
+void GameWorld::InsertObject(shared_ptr<GameObject> ptr)
 {
-	return GetCollisions(shared_ptr<GameObject>(optr));
+	// Add game object to the end of the dense array
+	ptr->SetWorldIndex((uint)mGameObjects.size());
+	mGameObjects.push_back(ptr);
+	// Add reference to this world
+	ptr->SetWorld(this);
+	// Render where the object is until it has been ticked
+	ptr->StorePreviousState();
+	// Move kinematic state into the store if it is in use
+	if (mKinematicsStoreEnabled) ptr->AttachKinematics(&mKinematicsStore);
 }
 
 /** Update all objects. */
 void GameWorld::UpdateObjects(int t)
 {
-	// Update every object in the world
-	GameObjectList::iterator it = mGameObjects.begin();
-	for(GameObjectList::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) 
+	// Integrate all objects in the kinematics store in a single pass
+	if (mKinematicsStoreEnabled) mKinematicsStore.Integrate(t, (float)mWidth, (float)mHeight);
+	// Update every object in the world, including any added during the update
+	size_t i = 0;
+	if (mJobSystem != NULL && mGameObjects.size() > mUpdateChunkSize) i = UpdateObjectsInParallel(t);
+	for (; i < mGameObjects.size(); i++)
 	{
-		(*it)->Update(t);
+		mGameObjects[i]->Update(t);
 	}
 }
 
-/** Update all collisions. */
-void GameWorld::UpdateCollisions(int t)
+/** Update the objects in the world across the threads of the job system, returning
+	how many were updated. Objects may only change themselves while updating, apart
+	from adding objects and flagging them for removal, which are queued and then
+	applied in the order they would have been had the objects updated in turn. */
+uint GameWorld::UpdateObjectsInParallel(int t)
 {
-	CollisionMap::iterator it1;
-	CollisionMap::iterator it2;
+	uint count = (uint)mGameObjects.size();
+	mCommandBuffers.resize(mJobSystem->GetNumThreads());
+	for (vector<CommandBuffer>::iterator it = mCommandBuffers.begin(); it != mCommandBuffers.end(); ++it) it->world = this;
+	mUpdatingInParallel = true;
+	mJobSystem->ParallelFor(count, mUpdateChunkSize, [this, t](uint begin, uint end, uint thread) {
+		// The thread may already be updating another world, such as one of a
+		// world runner's, so its buffer is put back afterwards
+		CommandBuffer* previous = mCurrentCommandBuffer;
+		CommandBuffer& buffer = mCommandBuffers[thread];
+		mCurrentCommandBuffer = &buffer;
+		for (uint i = begin; i < end; i++) {
+			buffer.source = i;
+			mGameObjects[i]->Update(t);
+		}
+		mCurrentCommandBuffer = previous;
+	});
+	mUpdatingInParallel = false;
+	ApplyCommandBuffers();
+	return count;
+}
 
-	// Clear collisions
-	for (it1 = mCollisions.begin(); it1 != mCollisions.end(); ++it1) {
-		GameObjectList &collisions = it1->second;
-		collisions.clear();
+/** Get the buffer to queue changes in while objects of this world are updating in
+	parallel, or NULL if changes should be made straight away. */
+GameWorld::CommandBuffer* GameWorld::GetCurrentCommandBuffer()
+{
+	if (!mUpdatingInParallel || mCurrentCommandBuffer == NULL) return NULL;
+	return (mCurrentCommandBuffer->world == this) ? mCurrentCommandBuffer : NULL;
+}
+
+/** Apply the changes queued by objects updating in parallel, in the order of the
+	objects that queued them, so the result does not depend on the thread count. */
+void GameWorld::ApplyCommandBuffers()
+{
+	mMergedRemovals.clear();
+	mMergedAdditions.clear();
+	for (vector<CommandBuffer>::iterator it = mCommandBuffers.begin(); it != mCommandBuffers.end(); ++it) {
+		mMergedRemovals.insert(mMergedRemovals.end(), it->removals.begin(), it->removals.end());
+		mMergedAdditions.insert(mMergedAdditions.end(), it->additions.begin(), it->additions.end());
+		it->removals.clear();
+		it->additions.clear();
 	}
 
-	// Update collisions
-	for (it1 = mCollisions.begin(); it1 != mCollisions.end(); ++it1) {
-		shared_ptr<GameObject> object1 = it1->first;
-		GameObjectList& collisions1 = it1->second;
-		for (it2 = mCollisions.begin(); it2 != mCollisions.end(); ++it2) {
-			shared_ptr<GameObject> object2 = it2->first;
-			GameObjectList& collisions2 = it2->second;
-			if (object2 != object1) {
-				if (object1->CollisionTest(object2)) {
-					collisions1.push_back(object2);
-					collisions2.push_back(object1);
-				}
-			}
-		}
+	// Each object was updated on one thread, so a stable sort keeps the order of
+	// commands from the same object
+	stable_sort(mMergedRemovals.begin(), mMergedRemovals.end(), CompareCommandSource< weak_ptr<GameObject> >);
+	stable_sort(mMergedAdditions.begin(), mMergedAdditions.end(), CompareCommandSource< shared_ptr<GameObject> >);
+	for (size_t i = 0; i < mMergedRemovals.size(); i++) FlagForRemoval(mMergedRemovals[i].second);
+	for (size_t i = 0; i < mMergedAdditions.size(); i++) AddObject(mMergedAdditions[i].second);
+	mMergedRemovals.clear();
+	mMergedAdditions.clear();
+}
+
+/** Update all collisions. */
+void GameWorld::UpdateCollisions(int t)
+{
+	// Find collisions using the selected method
+	switch (mCollisionMode)
+	{
+	case COLLISION_BRUTE_FORCE: FindCollisionsBruteForce(); break;
+	case COLLISION_SWEEP_AND_PRUNE: FindCollisions(&mSweepAndPrune); break;
+	default: FindCollisions(&mSpatialHash); break;
 	}
 
+	// Group the contacts into one contiguous run per colliding object
+	SortContacts();
 
-	// Call objects to handle collisions
-	it1 = mCollisions.begin();
-	while (it1 != mCollisions.end()) {
-		// We have to be careful and make a copy of the iterator
-		// before calling OnCollision() in case the object removes itself
-		it2 = it1++;
-		shared_ptr<GameObject> object = it2->first;
-		GameObjectList collisions = it2->second;
-		if (!collisions.empty()) object->OnCollision(collisions);
+	// Call objects to handle collisions, passing each a view of its run.
+	// Objects removed outright meanwhile stay in the world until every object
+	// has been called, so no index moves and no pointer in a run is freed.
+	mDispatchingCollisions = true;
+	for (vector<ContactRun>::iterator it = mContactRuns.begin(); it != mContactRuns.end(); ++it) {
+		GameObject* const* buffer = &mContactBuffer[0];
+		mGameObjects[it->index]->OnCollision(GameObjectSpan(buffer + it->begin, buffer + it->end));
+	}
+	mDispatchingCollisions = false;
+	for (size_t i = 0; i < mDeferredRemovals.size(); i++) {
+		RemoveObject(mDeferredRemovals[i].lock());
 	}
+	mDeferredRemovals.clear();
 }
 
 /** Utility method to wrap positions around the world's edges. */
@@ -209,4 +424,393 @@ void GameWorld::WrapXY(GLfloat &x, GLfloat &y)
 	while (y < -mHeight/2) y += mHeight; 
 }
 
+/** Utility method to turn an offset between two positions into the shortest
+	offset between them, for objects that wrapped around the world's edges. */
+void GameWorld::WrapOffset(GLfloat &dx, GLfloat &dy)
+{
+	if (dx >  mWidth/2)  dx -= mWidth;
+	if (dx < -mWidth/2)  dx += mWidth;
+	if (dy >  mHeight/2) dy -= mHeight;
+	if (dy < -mHeight/2) dy += mHeight;
+}
+
+/** Get a hash of the type and exact kinematic state of every object, in array
+	order, for checking that two runs of the world are bit-identical. */
+uint GameWorld::GetStateChecksum()
+{
+	// 32 bit FNV-1a over the bytes of each value
+	uint hash = 2166136261u;
+	for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+		GameObject* object = it->get();
+		GLVector3f position = object->GetPosition();
+		GLVector3f velocity = object->GetVelocity();
+		float values[] = { position.x, position.y, position.z, velocity.x, velocity.y, velocity.z, object->GetAngle() };
+		uint type_id = (uint)object->GetType().GetTypeID();
+		const uchar* bytes = (const uchar*)&type_id;
+		for (uint i = 0; i < sizeof(type_id); i++) hash = (hash ^ bytes[i]) * 16777619u;
+		bytes = (const uchar*)values;
+		for (uint i = 0; i < sizeof(values); i++) hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+/** Save the state of the world and of every object in it, in array order, so that
+	the world can be put back exactly as it is now. Settings such as the collision
+	mode are not saved. */
+void GameWorld::SaveState(StateWriter& writer)
+{
+	writer.Write(mWidth);
+	writer.Write(mHeight);
+	writer.Write(mTickCount);
+	writer.Write(mAccumulator);
+	writer.Write(mNumDroppedSteps);
+	writer.Write(mInterpolationAlpha);
+	writer.Write((uint)mGameObjects.size());
+	for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+		writer.Write((uint)(*it)->GetType().GetTypeID());
+		(*it)->SaveState(writer);
+	}
+	// Saved after the objects, as creating them to restore may draw from it
+	mRandom.SaveState(writer);
+}
+
+/** Replace the objects in the world with the saved ones, each created by factory
+	from its type and then restored, and restore the world's own state. Listeners
+	are not told of objects leaving or joining, as their own state should be restored
+	alongside. Returns false if an object could not be created or the state was
+	cut short, leaving the world part restored. */
+bool GameWorld::RestoreState(StateReader& reader, const ObjectFactory& factory)
+{
+	reader.Read(mWidth);
+	reader.Read(mHeight);
+	reader.Read(mTickCount);
+	reader.Read(mAccumulator);
+	reader.Read(mNumDroppedSteps);
+	reader.Read(mInterpolationAlpha);
+	uint num_objects = 0;
+	if (!reader.Read(num_objects)) return false;
+
+	for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+		(*it)->SetWorld(NULL);
+		(*it)->DetachKinematics();
+	}
+	mGameObjects.clear();
+	mGameObjectsToRemove.clear();
+	// Sorted endpoints point at the objects just let go of
+	mSweepAndPrune.Clear();
+
+	for (uint i = 0; i < num_objects; i++) {
+		uint type_id = 0;
+		if (!reader.Read(type_id)) return false;
+		shared_ptr<GameObject> object = factory(type_id);
+		if (object.get() == NULL || IsInWorld(object.get())) return false;
+		InsertObject(object);
+		object->RestoreState(reader);
+	}
+	mRandom.RestoreState(reader);
+	return !reader.HasFailed();
+}
+
+/** Get the number of bytes a snapshot of every object in the world takes. */
+uint GameWorld::GetSnapshotSize()
+{
+	return SNAPSHOT_HEADER_SIZE + (uint)mGameObjects.size() * SNAPSHOT_RECORD_SIZE;
+}
 
+/** Write a snapshot of the type and motion of every object, in array order, into
+	a buffer of size bytes, returning the number of bytes written, or 0 if not even
+	the header fits. Objects that do not fit are left out, which the header shows.
+	Nothing is allocated, so a snapshot can be taken every tick. */
+uint GameWorld::WriteSnapshot(uchar* buffer, uint size)
+{
+	static constexpr GameObjectType bounding_sphere_type = "BoundingSphere"_type;
+
+	if (size < SNAPSHOT_HEADER_SIZE) return 0;
+	SnapshotHeader header;
+	header.magic = WORLD_SNAPSHOT_MAGIC;
+	header.version = WORLD_SNAPSHOT_VERSION;
+	header.record_size = SNAPSHOT_RECORD_SIZE;
+	header.tick = mTickCount;
+	header.num_objects = (uint)mGameObjects.size();
+	header.num_records = min(header.num_objects, (size - SNAPSHOT_HEADER_SIZE) / SNAPSHOT_RECORD_SIZE);
+	uchar* p = WriteSnapshotHeader(buffer, header);
+
+	for (uint i = 0; i < header.num_records; i++) {
+		GameObject* object = mGameObjects[i].get();
+		const shared_ptr<BoundingShape>& shape = object->GetBoundingShape();
+		GLVector3f position = object->GetPosition();
+		GLVector3f velocity = object->GetVelocity();
+		SnapshotRecord record;
+		record.type_id = (uint)object->GetType().GetTypeID();
+		record.x = position.x;
+		record.y = position.y;
+		record.vx = velocity.x;
+		record.vy = velocity.y;
+		record.angle = object->GetAngle();
+		record.radius = 0;
+		if (shape.get() != NULL && shape->GetType() == bounding_sphere_type) record.radius = ((BoundingSphere*)shape.get())->GetRadius();
+		p = WriteSnapshotRecord(p, record);
+	}
+	return (uint)(p - buffer);
+}
+
+/** Check whether an object is in this world, without searching for it. */
+bool GameWorld::IsInWorld(GameObject* ptr)
+{
+	if (ptr == NULL || ptr->GetWorld() != this) return false;
+	uint index = ptr->GetWorldIndex();
+	return index < mGameObjects.size() && mGameObjects[index].get() == ptr;
+}
+
+/** Render an object, or add it to the sprite batch if it can be batched. */
+void GameWorld::RenderObject(GameObject* object, float alpha)
+{
+	if (mSpriteBatchingEnabled && object->RenderToBatch(mSpriteBatch, alpha)) return;
+	object->PreRender(alpha);
+	object->Render();
+	object->PostRender();
+}
+
+/** Find the indices of objects whose rendered bounds overlap the view, in index order. */
+void GameWorld::CullObjects(float alpha, float left, float bottom, float right, float top)
+{
+	mRenderProxies.resize(mGameObjects.size());
+	for (uint i = 0; i < mGameObjects.size(); i++) {
+		GameObject* object = mGameObjects[i].get();
+		GLVector3f position = object->GetRenderPosition(alpha);
+		BroadphaseProxy& proxy = mRenderProxies[i];
+		proxy.object = object;
+		proxy.x = position.x;
+		proxy.y = position.y;
+		proxy.radius = object->GetRenderRadius();
+	}
+	mRenderCuller.Cull(mRenderProxies, left, bottom, right, top, mRenderOrder);
+}
+
+/** Reorder the objects to render so that those drawn with the same state are
+	together, keeping them in index order within each state. */
+void GameWorld::SortByRenderState()
+{
+	mRenderKeys.resize(mRenderOrder.size());
+	for (uint i = 0; i < mRenderOrder.size(); i++) {
+		uint index = mRenderOrder[i];
+		mRenderKeys[i] = make_pair(mGameObjects[index]->GetRenderStateKey(), index);
+	}
+	sort(mRenderKeys.begin(), mRenderKeys.end());
+	for (uint i = 0; i < mRenderKeys.size(); i++) mRenderOrder[i] = mRenderKeys[i].second;
+}
+
+/** Switch between advancing the world by the time given to each update and
+	advancing it in ticks of a fixed length. */
+void GameWorld::SetFixedTimestepEnabled(bool enabled)
+{
+	if (enabled == mFixedTimestepEnabled) return;
+	mFixedTimestepEnabled = enabled;
+	mAccumulator = 0;
+	mTickCount = 0;
+	mInterpolationAlpha = 1.0f;
+	for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+		(*it)->StorePreviousState();
+	}
+}
+
+/** Set the number of fixed ticks per second of simulated time. */
+void GameWorld::SetTickRate(uint ticks_per_second)
+{
+	if (ticks_per_second == 0 || ticks_per_second == mTickRate) return;
+	// Keep the fraction of a tick already accumulated, and count ticks afresh
+	mTickRate = ticks_per_second;
+	mTickCount = 0;
+}
+
+/** Select how collisions are found. */
+void GameWorld::SetCollisionMode(CollisionMode m)
+{
+	mCollisionMode = m;
+	// Sorted endpoints are stale once the sweep and prune stops being updated
+	mSweepAndPrune.Clear();
+}
+
+/** Enable or disable the kinematics store, moving the state of all objects into or out of it. */
+void GameWorld::SetKinematicsStoreEnabled(bool enabled)
+{
+	if (enabled == mKinematicsStoreEnabled) return;
+	mKinematicsStoreEnabled = enabled;
+	for (GameObjectVector::iterator it = mGameObjects.begin(); it != mGameObjects.end(); ++it) {
+		if (enabled) { (*it)->AttachKinematics(&mKinematicsStore); }
+		else { (*it)->DetachKinematics(); }
+	}
+	if (!enabled) mKinematicsStore.Clear();
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Get the length of a tick in whole milliseconds. Where the tick rate does not
+	divide a second exactly, lengths vary by a millisecond so that every second
+	of ticks adds up to exactly 1000 milliseconds. */
+int GameWorld::GetTickLength(unsigned long long tick)
+{
+	uint k = (uint)(tick % mTickRate);
+	return (int)(((k + 1) * 1000) / mTickRate - (k * 1000) / mTickRate);
+}
+
+/** Find collisions by testing every pair of objects. */
+void GameWorld::FindCollisionsBruteForce()
+{
+	// Clear collisions
+	mContacts.clear();
+
+	// Update collisions
+	for (uint i1 = 0; i1 < (uint)mGameObjects.size(); i1++) {
+		const shared_ptr<GameObject>& object1 = mGameObjects[i1];
+		for (uint i2 = 0; i2 < (uint)mGameObjects.size(); i2++) {
+			const shared_ptr<GameObject>& object2 = mGameObjects[i2];
+			if (object2 != object1 && object1->CanCollideWith(*object2)) {
+				if (object1->CollisionTest(object2)) {
+					mContacts.push_back(Contact(i1, object2.get()));
+					mContacts.push_back(Contact(i2, object1.get()));
+				}
+			}
+		}
+	}
+}
+
+/** Find collisions by testing the candidate pairs produced by a broadphase. */
+void GameWorld::FindCollisions(IBroadphase* broadphase)
+{
+	static constexpr GameObjectType bounding_sphere_type = "BoundingSphere"_type;
+
+	mContacts.clear();
+	mProxies.clear();
+	mProxyIndices.clear();
+
+	// Submit every object with a bounding sphere to the broadphase
+	for (uint i = 0; i < (uint)mGameObjects.size(); i++) {
+		// Objects without a bounding sphere can never pass the narrowphase test
+		const shared_ptr<GameObject>& object = mGameObjects[i];
+		const shared_ptr<BoundingShape>& shape = object->GetBoundingShape();
+		if (shape.get() == NULL || shape->GetType() != bounding_sphere_type) continue;
+		GLVector3f position = object->GetPosition();
+		float radius = ((BoundingSphere*)shape.get())->GetRadius();
+		// Fast movers are tested along the path they took this step, so their
+		// proxy has to enclose the whole of it
+		if (object->IsFastMover()) {
+			GLVector3f motion = position - object->GetPreviousPosition();
+			WrapOffset(motion.x, motion.y);
+			position = object->GetPreviousPosition() + motion * 0.5f;
+			radius += motion.length() * 0.5f;
+		}
+		BroadphaseProxy proxy;
+		proxy.object = object.get();
+		proxy.x = position.x;
+		proxy.y = position.y;
+		proxy.radius = radius;
+		mProxies.push_back(proxy);
+		mProxyIndices.push_back(i);
+	}
+
+	// Find pairs of objects that are close enough to possibly collide
+	broadphase->FindPairs(mProxies, (float)mWidth, (float)mHeight, mCandidatePairs);
+
+	// Update collisions, testing each candidate pair both ways round
+	if (mJobSystem != NULL && mCandidatePairs.size() > mNarrowphaseChunkSize) {
+		TestCandidatePairsInParallel();
+		return;
+	}
+	Contact contacts[4];
+	for (CollisionPairList::iterator pit = mCandidatePairs.begin(); pit != mCandidatePairs.end(); ++pit) {
+		uint n = TestCandidatePair(*pit, contacts);
+		mContacts.insert(mContacts.end(), contacts, contacts + n);
+	}
+}
+
+/** Test the candidate pairs across the threads of the job system. Each thread
+	collects contacts in its own buffer, which are then merged back into the order
+	testing the pairs in turn would have found them, so that objects are told of
+	their collisions in the same order whatever the thread count. */
+void GameWorld::TestCandidatePairsInParallel()
+{
+	mNarrowphaseBuffers.resize(mJobSystem->GetNumThreads());
+	mJobSystem->ParallelFor((uint)mCandidatePairs.size(), mNarrowphaseChunkSize, [this](uint begin, uint end, uint thread) {
+		NarrowphaseBuffer& buffer = mNarrowphaseBuffers[thread];
+		NarrowphaseRun run = { thread, (uint)buffer.contacts.size(), 0 };
+		Contact contacts[4];
+		for (uint p = begin; p < end; p++) {
+			uint n = TestCandidatePair(mCandidatePairs[p], contacts);
+			buffer.contacts.insert(buffer.contacts.end(), contacts, contacts + n);
+		}
+		run.end = (uint)buffer.contacts.size();
+		buffer.runs.push_back(make_pair(begin, run));
+	});
+
+	// Each job tested a contiguous range of pairs in turn, so sorting the runs
+	// by the first pair of each puts every contact back in order
+	mMergedRuns.clear();
+	for (vector<NarrowphaseBuffer>::iterator it = mNarrowphaseBuffers.begin(); it != mNarrowphaseBuffers.end(); ++it) {
+		mMergedRuns.insert(mMergedRuns.end(), it->runs.begin(), it->runs.end());
+		it->runs.clear();
+	}
+	sort(mMergedRuns.begin(), mMergedRuns.end(), CompareCommandSource<NarrowphaseRun>);
+	for (size_t i = 0; i < mMergedRuns.size(); i++) {
+		const NarrowphaseRun& run = mMergedRuns[i].second;
+		const vector<Contact>& contacts = mNarrowphaseBuffers[run.thread].contacts;
+		mContacts.insert(mContacts.end(), contacts.begin() + run.begin, contacts.begin() + run.end);
+	}
+	for (vector<NarrowphaseBuffer>::iterator it = mNarrowphaseBuffers.begin(); it != mNarrowphaseBuffers.end(); ++it) {
+		it->contacts.clear();
+	}
+}
+
+/** Test a candidate pair both ways round, writing up to four contacts and
+	returning how many were written. Only reads the objects, so pairs can be
+	tested on different threads at once. */
+uint GameWorld::TestCandidatePair(const CollisionPair& pair, Contact* contacts)
+{
+	uint n = 0;
+	uint i1 = mProxyIndices[pair.first];
+	uint i2 = mProxyIndices[pair.second];
+	const shared_ptr<GameObject>& object1 = mGameObjects[i1];
+	const shared_ptr<GameObject>& object2 = mGameObjects[i2];
+	// Collision layers rule out most pairs without calling the narrowphase
+	if (object1->CanCollideWith(*object2) && object1->CollisionTest(object2)) {
+		contacts[n++] = Contact(i1, object2.get());
+		contacts[n++] = Contact(i2, object1.get());
+	}
+	if (object2->CanCollideWith(*object1) && object2->CollisionTest(object1)) {
+		contacts[n++] = Contact(i2, object1.get());
+		contacts[n++] = Contact(i1, object2.get());
+	}
+	return n;
+}
+
+/** Counting sort the contacts by object index into the contact buffer, keeping
+	the order in which each object's collisions were found, and record the run of
+	the buffer belonging to each object with collisions. */
+void GameWorld::SortContacts()
+{
+	uint n = (uint)mGameObjects.size();
+	mContactRuns.clear();
+	mContactBuffer.resize(mContacts.size());
+	ContactRun none = { NULL, 0, 0, 0 };
+	mContactRunsByIndex.assign(n, none);
+	if (mContacts.empty()) return;
+
+	// Count the contacts of each object, then turn the counts into start offsets
+	mContactOffsets.assign(n + 1, 0);
+	for (vector<Contact>::iterator it = mContacts.begin(); it != mContacts.end(); ++it) {
+		mContactOffsets[it->first + 1]++;
+	}
+	for (uint i = 0; i < n; i++) {
+		mContactOffsets[i + 1] += mContactOffsets[i];
+	}
+	// Record the runs before the offsets are used as insertion points
+	for (uint i = 0; i < n; i++) {
+		if (mContactOffsets[i] == mContactOffsets[i + 1]) continue;
+		ContactRun run = { mGameObjects[i].get(), i, mContactOffsets[i], mContactOffsets[i + 1] };
+		mContactRuns.push_back(run);
+		mContactRunsByIndex[i] = run;
+	}
+	for (vector<Contact>::iterator it = mContacts.begin(); it != mContacts.end(); ++it) {
+		mContactBuffer[mContactOffsets[it->first]++] = it->second;
+	}
+}
@@ -2,19 +2,42 @@
 #define __GAMEWORLD_H__
 
 #include "GameUtil.h"
+#include "GameObjectSpan.h"
 #include "IGameWorldListener.h"
+#include "SpatialHash.h"
+#include "SweepAndPrune.h"
+#include "KinematicsStore.h"
+#include "Random.h"
+#include "SpriteBatch.h"
+#include "RenderCuller.h"
+#include "JobSystem.h"
+#include <functional>
+#include <vector>
 
 class GameObject;
+class StateWriter;
+class StateReader;
 
 // Define a type of list to hold game objects
 typedef list< shared_ptr< GameObject > > GameObjectList;
-typedef list< weak_ptr< GameObject > > WeakGameObjectList;
+typedef vector< weak_ptr< GameObject > > WeakGameObjectVector;
 
-// Define a type of map to hold lists of collisions
-typedef map< shared_ptr<GameObject>, GameObjectList > CollisionMap;
+// Define a type of dense array to hold game objects, indexed by world index
+typedef vector< shared_ptr< GameObject > > GameObjectVector;
 
 class GameWorld
 {
+public:
+	enum CollisionMode
+	{
+		COLLISION_BRUTE_FORCE,
+		COLLISION_SPATIAL_HASH,
+		COLLISION_SWEEP_AND_PRUNE,
+	};
+
+	// Creates an object of a saved type when a world is restored, or returns NULL
+	typedef function< shared_ptr<GameObject> (uint type_id) > ObjectFactory;
+
 public:
 	GameWorld(void);
 	~GameWorld(void);
@@ -30,8 +53,8 @@ public:
 	void FlagForRemoval( GameObject* ptr );
 	void FlagForRemoval( weak_ptr<GameObject> ptr );
 
-	GameObjectList GetCollisions( shared_ptr<GameObject> ptr );
-	GameObjectList GetCollisions( GameObject* optr );
+	GameObjectSpan GetCollisions( shared_ptr<GameObject> ptr );
+	GameObjectSpan GetCollisions( GameObject* optr );
 
 	void AddListener( IGameWorldListener* lptr) { mListeners.push_back(lptr); }
 	void RemoveListener( IGameWorldListener* lptr) { mListeners.remove(lptr); }
@@ -47,21 +70,214 @@ public:
 	int GetHeight() { return mHeight; }
 
 	void WrapXY(float &x, float &y);
+	void WrapOffset(float &dx, float &dy);
+
+	bool IsInWorld(GameObject* ptr);
+	uint GetStateChecksum();
+
+	uint GetSnapshotSize();
+	uint WriteSnapshot(uchar* buffer, uint size);
+
+	void SaveState(StateWriter& writer);
+	bool RestoreState(StateReader& reader, const ObjectFactory& factory);
+
+	void SetCollisionMode(CollisionMode m);
+	CollisionMode GetCollisionMode() { return mCollisionMode; }
+
+	void SetFixedTimestepEnabled(bool enabled);
+	bool IsFixedTimestepEnabled() { return mFixedTimestepEnabled; }
+	void SetTickRate(uint ticks_per_second);
+	uint GetTickRate() { return mTickRate; }
+	void SetMaxStepsPerUpdate(uint n) { mMaxStepsPerUpdate = n; }
+	uint GetMaxStepsPerUpdate() { return mMaxStepsPerUpdate; }
+	float GetInterpolationAlpha() { return mInterpolationAlpha; }
+	unsigned long long GetTickCount() { return mTickCount; }
+	uint GetNumDroppedSteps() { return mNumDroppedSteps; }
+
+	void SetRandomSeed(uint seed) { mRandom.Seed(seed); }
+	uint GetRandomSeed() { return mRandom.GetSeed(); }
+	Random& GetRandom() { return mRandom; }
+	Random GetRandomSubstream(uint stream) { return mRandom.GetSubstream(stream); }
+
+	void SetJobSystem(JobSystem* job_system) { mJobSystem = job_system; }
+	JobSystem* GetJobSystem() { return mJobSystem; }
+	void SetUpdateChunkSize(uint n) { mUpdateChunkSize = max(n, 1u); }
+	uint GetUpdateChunkSize() { return mUpdateChunkSize; }
+	void SetNarrowphaseChunkSize(uint n) { mNarrowphaseChunkSize = max(n, 1u); }
+	uint GetNarrowphaseChunkSize() { return mNarrowphaseChunkSize; }
+
+	void SetKinematicsStoreEnabled(bool enabled);
+	bool IsKinematicsStoreEnabled() { return mKinematicsStoreEnabled; }
+	KinematicsStore& GetKinematicsStore() { return mKinematicsStore; }
+
+	void SetSpriteBatchingEnabled(bool enabled) { mSpriteBatchingEnabled = enabled; }
+	bool IsSpriteBatchingEnabled() { return mSpriteBatchingEnabled; }
+	const SpriteBatch& GetSpriteBatch() { return mSpriteBatch; }
+
+	void SetView(float x, float y, float w, float h);
+	void ResetView() { mViewSet = false; }
+	void GetViewBounds(float &left, float &bottom, float &right, float &top);
+
+	void SetRenderCullingEnabled(bool enabled) { mRenderCullingEnabled = enabled; }
+	bool IsRenderCullingEnabled() { return mRenderCullingEnabled; }
+	RenderCuller& GetRenderCuller() { return mRenderCuller; }
+	uint GetNumObjectsRendered() { return mRenderCullingEnabled ? (uint)mRenderOrder.size() : (uint)mGameObjects.size(); }
+
+	void SetRenderStateSortingEnabled(bool enabled) { mRenderStateSortingEnabled = enabled; }
+	bool IsRenderStateSortingEnabled() { return mRenderStateSortingEnabled; }
 
 	// added method
 	void RemoveAllObjects();
 
 protected:
+	// A contact holds the index of an object and an object it collides with
+	typedef pair< uint, GameObject* > Contact;
+	struct CommandBuffer;
+
+	void Step(int t);
+	void InsertObject(shared_ptr<GameObject> ptr);
+	int GetTickLength(unsigned long long tick);
 	void UpdateObjects(int t);
+	uint UpdateObjectsInParallel(int t);
+	CommandBuffer* GetCurrentCommandBuffer();
+	void ApplyCommandBuffers();
 	void UpdateCollisions(int t);
+	void FindCollisionsBruteForce();
+	void FindCollisions(IBroadphase* broadphase);
+	void TestCandidatePairsInParallel();
+	uint TestCandidatePair(const CollisionPair& pair, Contact* contacts);
+	void SortContacts();
+	void RenderObject(GameObject* object, float alpha);
+	void CullObjects(float alpha, float left, float bottom, float right, float top);
+	void SortByRenderState();
+
+	// Create a dense array of game objects, each of which knows its index
+	GameObjectVector mGameObjects;
+
+	// A run of the contact buffer holding every object one object collides with
+	struct ContactRun
+	{
+		GameObject* object;
+		// World index of the object when the contacts were sorted
+		uint index;
+		uint begin;
+		uint end;
+	};
+	// Contacts in the order the narrowphase found them
+	vector< Contact > mContacts;
+	// Colliding objects grouped by the object they collide with, in index order,
+	// and the run of the buffer belonging to each object that has collisions
+	vector< uint > mContactOffsets;
+	vector< GameObject* > mContactBuffer;
+	vector< ContactRun > mContactRuns;
+	// The run of each object by world index, for looking up one object's
+	// collisions directly. Runs follow objects moved by removals
+	vector< ContactRun > mContactRunsByIndex;
+	// Whether objects are being told of their collisions, so that removing one
+	// outright must wait until every object has been told
+	bool mDispatchingCollisions;
+	WeakGameObjectVector mDeferredRemovals;
+
+	// Broadphases used to find candidate pairs for collision testing
+	CollisionMode mCollisionMode;
+	SpatialHash mSpatialHash;
+	SweepAndPrune mSweepAndPrune;
+	// Proxies for objects with bounding spheres and their world indices
+	BroadphaseProxyList mProxies;
+	vector< uint > mProxyIndices;
+	// Candidate pairs produced by the broadphase
+	CollisionPairList mCandidatePairs;
+	// Number of candidate pairs in each narrowphase job
+	uint mNarrowphaseChunkSize;
+	// A run of the buffer of a thread holding the contacts one job found
+	struct NarrowphaseRun
+	{
+		uint thread;
+		uint begin;
+		uint end;
+	};
+	// Contacts the narrowphase found on one thread, and the runs of them each
+	// tagged with the index of the first candidate pair its job tested
+	struct NarrowphaseBuffer
+	{
+		vector< Contact > contacts;
+		vector< pair< uint, NarrowphaseRun > > runs;
+		// Keep buffers of different threads on different cache lines
+		uchar padding[64];
+	};
+	vector< NarrowphaseBuffer > mNarrowphaseBuffers;
+	vector< pair< uint, NarrowphaseRun > > mMergedRuns;
 
-	// Create a map of named game objects
-	GameObjectList mGameObjects;
-	// Create a map of colliding game objects
-	CollisionMap mCollisions;
+	// Threads to update objects across, if any, and the number of objects in each job
+	JobSystem* mJobSystem;
+	uint mUpdateChunkSize;
+	// Whether objects are being updated across threads, so that changes they
+	// make to the world must be queued in the buffer of their thread
+	bool mUpdatingInParallel;
+	// Changes to the world requested by the objects one thread updated, each
+	// tagged with the index of the object that requested it
+	struct CommandBuffer
+	{
+		GameWorld* world;
+		uint source;
+		vector< pair< uint, weak_ptr< GameObject > > > removals;
+		vector< pair< uint, shared_ptr< GameObject > > > additions;
+		// Keep buffers of different threads on different cache lines
+		uchar padding[64];
+	};
+	vector< CommandBuffer > mCommandBuffers;
+	// Buffer of the thread calling, set by each update job around the objects
+	// it updates, so it does not matter which job system runs the job
+	static thread_local CommandBuffer* mCurrentCommandBuffer;
+	vector< pair< uint, weak_ptr< GameObject > > > mMergedRemovals;
+	vector< pair< uint, shared_ptr< GameObject > > > mMergedAdditions;
+
+	// Contiguous kinematic state of all objects, when enabled
+	bool mKinematicsStoreEnabled;
+	KinematicsStore mKinematicsStore;
+
+	// Batch that sprite-only objects are drawn through together, when enabled
+	bool mSpriteBatchingEnabled;
+	SpriteBatch mSpriteBatch;
+
+	// Area of the world to render, centred on (mViewX, mViewY), if not all of it
+	bool mViewSet;
+	float mViewX;
+	float mViewY;
+	float mViewWidth;
+	float mViewHeight;
+
+	// Whether objects outside the view are skipped when rendering, and the
+	// bounds of each object to test
+	bool mRenderCullingEnabled;
+	RenderCuller mRenderCuller;
+	BroadphaseProxyList mRenderProxies;
+	// Whether objects are rendered grouped by render state, and the key of each
+	bool mRenderStateSortingEnabled;
+	vector< pair< uint, uint > > mRenderKeys;
+	// Indices of the objects to render, in the order to render them
+	vector< uint > mRenderOrder;
 
 	// Objects to remove when the update has completed
-	WeakGameObjectList mGameObjectsToRemove;
+	WeakGameObjectVector mGameObjectsToRemove;
+
+	// Whether updates advance the world in fixed ticks rather than by the time given
+	bool mFixedTimestepEnabled;
+	uint mTickRate;
+	// Most ticks to run in one update before giving up on catching up
+	uint mMaxStepsPerUpdate;
+	// Time not yet simulated, in units of 1/1000 of a tick
+	unsigned long long mAccumulator;
+	// Ticks run since fixed timestep was enabled
+	unsigned long long mTickCount;
+	// Ticks dropped because an update fell too far behind
+	uint mNumDroppedSteps;
+	// How far the accumulated time is between the last tick and the next
+	float mInterpolationAlpha;
+
+	// Generator for everything random in this world, so that each world is
+	// reproducible from its own seed whatever other worlds are doing
+	Random mRandom;
 
 	// Define a type of list to hold game world listeners
 	typedef list< IGameWorldListener* > GameWorldListenerList;
@@ -0,0 +1,194 @@
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "HeadlessSession.h"
+#include "StateStream.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Construct a session with a world of the given size and no window, display or
+	GLUT session. The default size matches the world of a windowed GameSession. */
+HeadlessSession::HeadlessSession(int w, int h)
+	: mNextTimerId(0),
+	  mRunning(false),
+	  mElapsedTime(0),
+	  mFrameCount(0)
+{
+	mGameWorld = new GameWorld();
+	mGameWorld->SetWidth(w);
+	mGameWorld->SetHeight(h);
+}
+
+/** Destructor. */
+HeadlessSession::~HeadlessSession()
+{
+	delete mGameWorld;
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Start the game. Nothing happens until the session is ticked. */
+void HeadlessSession::Start(void)
+{
+	mRunning = true;
+	RecordRewindState();
+}
+
+/** Stop the game. Ticks after this do nothing, and the caller regains control. */
+void HeadlessSession::Stop(void)
+{
+	mRunning = false;
+}
+
+/** Advance simulated time by dt milliseconds, updating the world and then firing
+	any timers that have fallen due, as the idle loop and GLUT timers would. */
+void HeadlessSession::Tick(int dt)
+{
+	if (!mRunning) return;
+	mElapsedTime += dt;
+	mFrameCount++;
+	mGameWorld->Update(dt);
+	FireTimers();
+	RecordRewindState();
+}
+
+/** Tick the session num_frames times with a fixed dt, as fast as possible. */
+void HeadlessSession::Run(uint num_frames, int dt)
+{
+	for (uint i = 0; i < num_frames && mRunning; i++) Tick(dt);
+}
+
+/** Call a listener with value once msecs of simulated time have passed. */
+void HeadlessSession::SetTimer(uint msecs, ITimerListener* listener, int value)
+{
+	TimerKey key(mElapsedTime + msecs, mNextTimerId++);
+	mTimerListeners[key] = ListenerValuePair(listener, value);
+}
+
+/** Save the state of the session and its world. Only timers set by the session
+	for itself are saved, as other listeners cannot be saved with them. */
+void HeadlessSession::SaveState(StateWriter& writer)
+{
+	writer.Write(SAVED_STATE_MAGIC);
+	writer.Write(SAVED_STATE_VERSION);
+	writer.Write(mElapsedTime);
+	writer.Write(mFrameCount);
+	writer.Write(mNextTimerId);
+	writer.Write(mRunning);
+	uint num_timers = 0;
+	for (TimerListenerMap::iterator it = mTimerListeners.begin(); it != mTimerListeners.end(); ++it) {
+		if (it->second.first == this) num_timers++;
+	}
+	writer.Write(num_timers);
+	for (TimerListenerMap::iterator it = mTimerListeners.begin(); it != mTimerListeners.end(); ++it) {
+		if (it->second.first != this) continue;
+		writer.Write(it->first.first);
+		writer.Write(it->first.second);
+		writer.Write(it->second.second);
+	}
+	mGameWorld->SaveState(writer);
+}
+
+/** Restore a state saved by SaveState, of this session or another of the same
+	kind, recreating the world's objects with CreateObject. Timers set by other
+	listeners are kept and fall due after the same simulated time as before.
+	Returns false if the state is not one this session saves or is cut short. */
+bool HeadlessSession::RestoreState(StateReader& reader)
+{
+	uint magic = 0, version = 0;
+	reader.Read(magic);
+	reader.Read(version);
+	if (magic != SAVED_STATE_MAGIC || version != SAVED_STATE_VERSION) return false;
+	// Set aside the timers of other listeners, which were not saved with the state
+	TimerListenerMap other_timers;
+	for (TimerListenerMap::iterator it = mTimerListeners.begin(); it != mTimerListeners.end(); ++it) {
+		if (it->second.first == this) continue;
+		TimerKey key(it->first.first - min(it->first.first, mElapsedTime), it->first.second);
+		other_timers[key] = it->second;
+	}
+	reader.Read(mElapsedTime);
+	reader.Read(mFrameCount);
+	reader.Read(mNextTimerId);
+	reader.Read(mRunning);
+	uint num_timers = 0;
+	reader.Read(num_timers);
+	mTimerListeners.clear();
+	for (uint i = 0; i < num_timers && !reader.HasFailed(); i++) {
+		TimerKey key;
+		int value = 0;
+		reader.Read(key.first);
+		reader.Read(key.second);
+		reader.Read(value);
+		mTimerListeners[key] = ListenerValuePair(this, value);
+	}
+	// Set them again from the restored time, in the order they fall due
+	for (TimerListenerMap::iterator it = other_timers.begin(); it != other_timers.end(); ++it) {
+		SetTimer(it->first.first, it->second.first, it->second.second);
+	}
+	GameWorld::ObjectFactory factory = [this](uint type_id) { return CreateObject(type_id); };
+	return mGameWorld->RestoreState(reader, factory) && !reader.HasFailed();
+}
+
+/** Keep the state after each of the last num_frames ticks, so the session can go
+	back to any of them. Every keyframe_interval-th state is kept whole and the rest
+	as their differences from it. A capacity of zero stops keeping states. */
+void HeadlessSession::SetRewindCapacity(uint num_frames, uint keyframe_interval)
+{
+	mRewindRing.SetKeyframeInterval(keyframe_interval);
+	mRewindRing.SetCapacity(num_frames);
+	if (num_frames == 0) mRewindRing.Clear();
+}
+
+/** Go back to the latest kept state at least msecs of simulated time ago, or the
+	start if that is less than msecs ago, forgetting the states after it. Returns
+	false if no kept state goes back that far. */
+bool HeadlessSession::Rewind(uint msecs)
+{
+	uint time = (msecs < mElapsedTime) ? mElapsedTime - msecs : 0;
+	int steps_back = mRewindRing.FindStepsBack(time);
+	if (steps_back < 0 || !mRewindRing.Get(steps_back, mRewindBuffer)) return false;
+	StateReader reader(mRewindBuffer);
+	if (!RestoreState(reader)) return false;
+	mRewindRing.DropNewest(steps_back);
+	return true;
+}
+
+/** Get the kept state Rewind would go back to, without going back, so that
+	another session can restore it and branch off from that point. */
+bool HeadlessSession::GetRewindState(uint msecs, vector<uchar>& state)
+{
+	uint time = (msecs < mElapsedTime) ? mElapsedTime - msecs : 0;
+	int steps_back = mRewindRing.FindStepsBack(time);
+	return steps_back >= 0 && mRewindRing.Get(steps_back, state);
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Protected method to set a timer. */
+void HeadlessSession::SetTimer(uint msecs, int value)
+{
+	SetTimer(msecs, this, value);
+}
+
+/** Call and remove every timer that has fallen due, including any that the
+	calls themselves set to fall due now. */
+void HeadlessSession::FireTimers(void)
+{
+	while (!mTimerListeners.empty()) {
+		TimerListenerMap::iterator i = mTimerListeners.begin();
+		if (i->first.first > mElapsedTime) break;
+		ITimerListener* listener = (i->second).first;
+		int value = (i->second).second;
+		// Remove the timer before calling the listener, which may set another
+		mTimerListeners.erase(i);
+		listener->OnTimer(value);
+	}
+}
+
+/** Keep the state of the session as it is now, if states are being kept. */
+void HeadlessSession::RecordRewindState(void)
+{
+	if (mRewindRing.GetCapacity() == 0) return;
+	StateWriter writer(mRewindBuffer);
+	SaveState(writer);
+	mRewindRing.Push(mRewindBuffer, mElapsedTime);
+}
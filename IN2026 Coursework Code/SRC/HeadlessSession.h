@@ -0,0 +1,74 @@
+#ifndef __HEADLESSSESSION_H__
+#define __HEADLESSSESSION_H__
+
+#include "GameUtil.h"
+#include "ITimerListener.h"
+#include "StateRing.h"
+#include <vector>
+
+class GameObject;
+class GameWorld;
+class StateWriter;
+class StateReader;
+
+class HeadlessSession : public ITimerListener
+{
+public:
+	HeadlessSession(int w = 133, int h = 133);
+	virtual ~HeadlessSession(void);
+
+	virtual void OnTimer(int value) {}
+
+	virtual void Start(void);
+	virtual void Stop(void);
+
+	void Tick(int dt);
+	void Run(uint num_frames, int dt);
+
+	void SetTimer(uint msecs, ITimerListener* listener, int value = 0);
+
+	bool IsRunning() { return mRunning; }
+	uint GetElapsedTime() { return mElapsedTime; }
+	uint GetFrameCount() { return mFrameCount; }
+	uint GetNumPendingTimers() { return (uint)mTimerListeners.size(); }
+
+	GameWorld* GetWorld() { return mGameWorld; }
+
+	virtual void SaveState(StateWriter& writer);
+	virtual bool RestoreState(StateReader& reader);
+
+	void SetRewindCapacity(uint num_frames, uint keyframe_interval = 60);
+	bool Rewind(uint msecs);
+	bool GetRewindState(uint msecs, vector<uchar>& state);
+	StateRing& GetRewindRing() { return mRewindRing; }
+
+protected:
+	GameWorld* mGameWorld;
+
+	void SetTimer(uint msecs, int value);
+	void FireTimers(void);
+	void RecordRewindState(void);
+
+	// Create an object of a saved type for the world to restore into, or NULL
+	// if the session does not know the type
+	virtual shared_ptr<GameObject> CreateObject(uint type_id) { return shared_ptr<GameObject>(); }
+
+	// Timers are keyed by the simulated time they fall due and the order they
+	// were set in, so timers due at the same time fire in the order they were set
+	typedef pair<ITimerListener*, int> ListenerValuePair;
+	typedef pair<uint, uint> TimerKey;
+	typedef map<TimerKey, ListenerValuePair> TimerListenerMap;
+	TimerListenerMap mTimerListeners;
+	uint mNextTimerId;
+
+	bool mRunning;
+	// Simulated milliseconds and frames since the session started
+	uint mElapsedTime;
+	uint mFrameCount;
+
+	// States saved after each tick, to go back to, and the buffer they are saved in
+	StateRing mRewindRing;
+	vector< uchar > mRewindBuffer;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef __IBROADPHASE_H__
+#define __IBROADPHASE_H__
+
+#include "GameUtil.h"
+#include <vector>
+
+class GameObject;
+
+// A bounding circle in the XY plane submitted to a broadphase
+struct BroadphaseProxy
+{
+	GameObject* object;
+	float x;
+	float y;
+	float radius;
+};
+
+// Define a type of list to hold broadphase proxies
+typedef vector< BroadphaseProxy > BroadphaseProxyList;
+
+// A candidate pair holds the indices of two proxies, lowest index first
+typedef pair< uint, uint > CollisionPair;
+typedef vector< CollisionPair > CollisionPairList;
+
+class IBroadphase
+{
+public:
+	virtual void FindPairs(const BroadphaseProxyList& proxies, float width, float height, CollisionPairList& pairs) = 0;
+};
+
+#endif
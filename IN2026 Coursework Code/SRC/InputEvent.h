@@ -0,0 +1,34 @@
+#ifndef __INPUTEVENT_H__
+#define __INPUTEVENT_H__
+
+#include "GameUtil.h"
+
+// An input that reached a game session, stamped with the number of fixed world
+// ticks that had completed when it arrived
+struct InputEvent
+{
+	enum Type
+	{
+		KEY_PRESSED,
+		KEY_RELEASED,
+		SPECIAL_KEY_PRESSED,
+		SPECIAL_KEY_RELEASED,
+		TIMER,
+		// Not an input: the world's state checksum at the end of a frame
+		CHECKSUM,
+	};
+
+	uint frame;
+	uchar type;
+	// Key code, timer value or checksum
+	int value;
+	int x;
+	int y;
+};
+
+// Recordings start with a magic number, a version and the session's random seed,
+// followed by each event as packed little-endian fields
+const uint INPUT_RECORDING_MAGIC = 0x504E4952; // "RINP"
+const uint INPUT_RECORDING_VERSION = 1;
+
+#endif
@@ -0,0 +1,82 @@
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "InputRecorder.h"
+
+/** Write a field low byte first, whatever the byte order of the machine. */
+static void WriteLittleEndian(ofstream& file, uint value)
+{
+	uchar bytes[4] = { (uchar)value, (uchar)(value >> 8), (uchar)(value >> 16), (uchar)(value >> 24) };
+	file.write((const char*)bytes, sizeof(bytes));
+}
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+InputRecorder::InputRecorder(void)
+	: mWorld(NULL),
+	  mNumEvents(0)
+{
+}
+
+/** Destructor. */
+InputRecorder::~InputRecorder(void)
+{
+	Close();
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Start recording inputs to a file, stamped with the ticks completed by a world
+	that runs with a fixed timestep. The recorder must also be added to the world
+	as a listener, to record its checksum every frame. */
+bool InputRecorder::Open(const string& filename, GameWorld* world, uint seed)
+{
+	Close();
+	mFile.open(filename.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!mFile.is_open()) return false;
+	mWorld = world;
+	mNumEvents = 0;
+	WriteLittleEndian(mFile, INPUT_RECORDING_MAGIC);
+	WriteLittleEndian(mFile, INPUT_RECORDING_VERSION);
+	WriteLittleEndian(mFile, seed);
+	mFile.flush();
+	return true;
+}
+
+/** Stop recording. */
+void InputRecorder::Close(void)
+{
+	if (mFile.is_open()) mFile.close();
+	mWorld = NULL;
+}
+
+/** Record an input that has just reached the session. */
+void InputRecorder::Record(InputEvent::Type type, int value, int x, int y)
+{
+	if (!IsRecording()) return;
+	InputEvent e = { (uint)mWorld->GetTickCount(), (uchar)type, value, x, y };
+	Write(e);
+	mNumEvents++;
+}
+
+/** Record the state checksum of the world at the end of every tick. The file is
+	flushed each tick, as GLUT sessions end by calling exit. */
+void InputRecorder::OnWorldUpdated(GameWorld* world)
+{
+	if (!IsRecording() || world != mWorld) return;
+	InputEvent e = { (uint)world->GetTickCount(), (uchar)InputEvent::CHECKSUM, (int)world->GetStateChecksum(), 0, 0 };
+	Write(e);
+	mFile.flush();
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Write an event as packed little-endian fields. */
+void InputRecorder::Write(const InputEvent& e)
+{
+	WriteLittleEndian(mFile, e.frame);
+	mFile.write((const char*)&e.type, sizeof(e.type));
+	WriteLittleEndian(mFile, (uint)e.value);
+	WriteLittleEndian(mFile, (uint)e.x);
+	WriteLittleEndian(mFile, (uint)e.y);
+}
@@ -0,0 +1,34 @@
+#ifndef __INPUTRECORDER_H__
+#define __INPUTRECORDER_H__
+
+#include "GameUtil.h"
+#include "IGameWorldListener.h"
+#include "InputEvent.h"
+
+class InputRecorder : public IGameWorldListener
+{
+public:
+	InputRecorder(void);
+	virtual ~InputRecorder(void);
+
+	bool Open(const string& filename, GameWorld* world, uint seed);
+	void Close(void);
+	bool IsRecording() { return mFile.is_open(); }
+
+	void Record(InputEvent::Type type, int value, int x = 0, int y = 0);
+
+	void OnWorldUpdated(GameWorld* world);
+	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object) {}
+	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object) {}
+
+	uint GetNumEvents() { return mNumEvents; }
+
+protected:
+	void Write(const InputEvent& e);
+
+	ofstream mFile;
+	GameWorld* mWorld;
+	uint mNumEvents;
+};
+
+#endif
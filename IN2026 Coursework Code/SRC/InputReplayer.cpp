@@ -0,0 +1,122 @@
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "IKeyboardListener.h"
+#include "ITimerListener.h"
+#include "InputReplayer.h"
+
+/** Read a field written low byte first, whatever the byte order of the machine. */
+static uint ReadLittleEndian(ifstream& file)
+{
+	uchar bytes[4] = { 0, 0, 0, 0 };
+	file.read((char*)bytes, sizeof(bytes));
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint)bytes[3] << 24);
+}
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+InputReplayer::InputReplayer(void)
+	: mSeed(0),
+	  mNextEvent(0),
+	  mWorld(NULL),
+	  mKeyboardListener(NULL),
+	  mTimerListener(NULL),
+	  mDelivering(false),
+	  mNumChecksMatched(0),
+	  mDiverged(false),
+	  mDivergedFrame(0)
+{
+}
+
+/** Destructor. */
+InputReplayer::~InputReplayer(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Load a recording made by an InputRecorder. */
+bool InputReplayer::Load(const string& filename)
+{
+	ifstream file(filename.c_str(), ios::in | ios::binary);
+	if (!file.is_open()) return false;
+	uint magic = ReadLittleEndian(file);
+	uint version = ReadLittleEndian(file);
+	mSeed = ReadLittleEndian(file);
+	if (!file || magic != INPUT_RECORDING_MAGIC || version != INPUT_RECORDING_VERSION) return false;
+	mEvents.clear();
+	InputEvent e;
+	while (Read(file, e)) mEvents.push_back(e);
+	mNextEvent = 0;
+	return true;
+}
+
+/** Start passing recorded inputs to listeners as a world reaches the frames they
+	were recorded at. The world must run with a fixed timestep from its first
+	tick, have the replayer as a listener, and be seeded with GetSeed. Inputs
+	recorded before the first tick are passed on straight away. */
+void InputReplayer::Start(GameWorld* world, IKeyboardListener* keyboard, ITimerListener* timer)
+{
+	mWorld = world;
+	mKeyboardListener = keyboard;
+	mTimerListener = timer;
+	mNextEvent = 0;
+	mNumChecksMatched = 0;
+	mDiverged = false;
+	mDivergedFrame = 0;
+	DeliverEvents(0);
+}
+
+/** Stop passing on recorded inputs, so that live inputs are accepted again. */
+void InputReplayer::Stop(void)
+{
+	mWorld = NULL;
+}
+
+/** Compare the world against the recording at the end of each tick, then pass on
+	the inputs that arrived before the next one. */
+void InputReplayer::OnWorldUpdated(GameWorld* world)
+{
+	if (world != mWorld) return;
+	DeliverEvents((uint)world->GetTickCount());
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Pass on every recorded input of a frame, in the order they were recorded. */
+void InputReplayer::DeliverEvents(uint frame)
+{
+	mDelivering = true;
+	while (mNextEvent < mEvents.size() && mEvents[mNextEvent].frame <= frame && mWorld) {
+		const InputEvent& e = mEvents[mNextEvent++];
+		switch (e.type)
+		{
+		case InputEvent::KEY_PRESSED: mKeyboardListener->OnKeyPressed((uchar)e.value, e.x, e.y); break;
+		case InputEvent::KEY_RELEASED: mKeyboardListener->OnKeyReleased((uchar)e.value, e.x, e.y); break;
+		case InputEvent::SPECIAL_KEY_PRESSED: mKeyboardListener->OnSpecialKeyPressed(e.value, e.x, e.y); break;
+		case InputEvent::SPECIAL_KEY_RELEASED: mKeyboardListener->OnSpecialKeyReleased(e.value, e.x, e.y); break;
+		case InputEvent::TIMER: mTimerListener->OnTimer(e.value); break;
+		case InputEvent::CHECKSUM:
+			if ((uint)e.value == mWorld->GetStateChecksum()) {
+				mNumChecksMatched++;
+			} else if (!mDiverged) {
+				mDiverged = true;
+				mDivergedFrame = e.frame;
+			}
+			break;
+		default: break;
+		}
+	}
+	mDelivering = false;
+}
+
+/** Read an event as packed little-endian fields. */
+bool InputReplayer::Read(ifstream& file, InputEvent& e)
+{
+	e.frame = ReadLittleEndian(file);
+	file.read((char*)&e.type, sizeof(e.type));
+	e.value = (int)ReadLittleEndian(file);
+	e.x = (int)ReadLittleEndian(file);
+	e.y = (int)ReadLittleEndian(file);
+	return !file.fail();
+}
@@ -0,0 +1,56 @@
+#ifndef __INPUTREPLAYER_H__
+#define __INPUTREPLAYER_H__
+
+#include "GameUtil.h"
+#include "IGameWorldListener.h"
+#include "InputEvent.h"
+#include <vector>
+
+class IKeyboardListener;
+class ITimerListener;
+
+class InputReplayer : public IGameWorldListener
+{
+public:
+	InputReplayer(void);
+	virtual ~InputReplayer(void);
+
+	bool Load(const string& filename);
+	uint GetSeed() { return mSeed; }
+
+	void Start(GameWorld* world, IKeyboardListener* keyboard, ITimerListener* timer);
+	void Stop(void);
+
+	bool IsReplaying() { return mWorld != NULL; }
+	bool IsDelivering() { return mDelivering; }
+	bool IsFinished() { return mNextEvent >= mEvents.size(); }
+
+	void OnWorldUpdated(GameWorld* world);
+	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object) {}
+	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object) {}
+
+	uint GetNumChecksMatched() { return mNumChecksMatched; }
+	bool IsInSync() { return !mDiverged; }
+	uint GetDivergedFrame() { return mDivergedFrame; }
+
+protected:
+	void DeliverEvents(uint frame);
+	bool Read(ifstream& file, InputEvent& e);
+
+	uint mSeed;
+	vector< InputEvent > mEvents;
+	uint mNextEvent;
+
+	GameWorld* mWorld;
+	IKeyboardListener* mKeyboardListener;
+	ITimerListener* mTimerListener;
+	// Whether recorded inputs are being passed on, so sessions can tell them apart from live ones
+	bool mDelivering;
+
+	// Frame by frame comparison of the replay against the recording
+	uint mNumChecksMatched;
+	bool mDiverged;
+	uint mDivergedFrame;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "GameUtil.h"
+#include "JobSystem.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Constructor. Starts num_threads - 1 workers, as the thread calling ParallelFor
+	also runs jobs. With num_threads of 0 there is a thread for each core. */
+JobSystem::JobSystem(uint num_threads)
+	: mJob(NULL),
+	  mNumChunksLeft(0),
+	  mNumSteals(0),
+	  mGeneration(0),
+	  mStopping(false)
+{
+	if (num_threads == 0) num_threads = max(thread::hardware_concurrency(), 1u);
+	for (uint i = 0; i < num_threads; i++) mQueues.push_back(new WorkQueue());
+	for (uint i = 1; i < num_threads; i++) mWorkers.push_back(thread(&JobSystem::WorkerMain, this, i));
+}
+
+/** Destructor. Stops and joins the workers. */
+JobSystem::~JobSystem(void)
+{
+	{
+		unique_lock<mutex> lock(mWakeLock);
+		mStopping = true;
+	}
+	mWake.notify_all();
+	for (vector<thread>::iterator it = mWorkers.begin(); it != mWorkers.end(); ++it) it->join();
+	for (vector<WorkQueue*>::iterator it = mQueues.begin(); it != mQueues.end(); ++it) delete *it;
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Call job on every item from 0 to count, split into chunks of grain items spread
+	across the threads, and return when all of them have been processed. Which
+	thread processes which chunk varies from call to call. */
+void JobSystem::ParallelFor(uint count, uint grain, const RangeJob& job)
+{
+	if (count == 0) return;
+	grain = max(grain, 1u);
+	uint num_chunks = (count + grain - 1) / grain;
+
+	// Not worth waking the workers for
+	if (num_chunks == 1 || mWorkers.empty()) {
+		job(0, count, 0);
+		return;
+	}
+
+	// Publish the job before any chunk of it can be taken
+	{
+		unique_lock<mutex> lock(mWakeLock);
+		mJob = &job;
+		mNumChunksLeft = num_chunks;
+	}
+
+	// Deal contiguous runs of chunks to each thread so neighbouring items usually
+	// stay on one thread, then wake the workers
+	uint num_threads = GetNumThreads();
+	for (uint c = 0; c < num_chunks; c++) {
+		Chunk chunk;
+		chunk.begin = c * grain;
+		chunk.end = min(chunk.begin + grain, count);
+		WorkQueue* queue = mQueues[(c * num_threads) / num_chunks];
+		lock_guard<mutex> lock(queue->lock);
+		queue->chunks.push_front(chunk);
+	}
+	{
+		unique_lock<mutex> lock(mWakeLock);
+		mGeneration++;
+	}
+	mWake.notify_all();
+
+	// Work alongside the workers, then wait for the chunks they are still running
+	RunChunks(0);
+	unique_lock<mutex> lock(mWakeLock);
+	mDone.wait(lock, [this] { return mNumChunksLeft == 0; });
+	mJob = NULL;
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Run jobs each time a new one is queued, until the job system is destroyed. */
+void JobSystem::WorkerMain(uint thread)
+{
+	uint generation = 0;
+	while (true) {
+		{
+			unique_lock<mutex> lock(mWakeLock);
+			mWake.wait(lock, [this, generation] { return mStopping || mGeneration != generation; });
+			if (mStopping) return;
+			generation = mGeneration;
+		}
+		RunChunks(thread);
+	}
+}
+
+/** Process chunks of the current job until there are none left to take. */
+void JobSystem::RunChunks(uint thread)
+{
+	Chunk chunk;
+	while (TakeChunk(thread, chunk)) {
+		(*mJob)(chunk.begin, chunk.end, thread);
+		if (--mNumChunksLeft == 0) {
+			// Take the lock so the caller cannot miss the notification
+			lock_guard<mutex> lock(mWakeLock);
+			mDone.notify_all();
+		}
+	}
+}
+
+/** Take a chunk from this thread's queue, or steal one from another thread's. */
+bool JobSystem::TakeChunk(uint thread, Chunk& chunk)
+{
+	uint num_threads = GetNumThreads();
+	for (uint i = 0; i < num_threads; i++) {
+		uint victim = (thread + i) % num_threads;
+		WorkQueue* queue = mQueues[victim];
+		lock_guard<mutex> lock(queue->lock);
+		if (queue->chunks.empty()) continue;
+		if (i == 0) {
+			chunk = queue->chunks.back();
+			queue->chunks.pop_back();
+		} else {
+			chunk = queue->chunks.front();
+			queue->chunks.pop_front();
+			mNumSteals++;
+		}
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,63 @@
+#ifndef __JOBSYSTEM_H__
+#define __JOBSYSTEM_H__
+
+#include "GameUtil.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+	// A job is called with a range of items to process and the index of the thread running it
+	typedef function< void (uint begin, uint end, uint thread) > RangeJob;
+
+	JobSystem(uint num_threads = 0);
+	~JobSystem(void);
+
+	void ParallelFor(uint count, uint grain, const RangeJob& job);
+
+	uint GetNumThreads() const { return (uint)mQueues.size(); }
+	uint GetNumSteals() const { return mNumSteals; }
+
+protected:
+	// A range of items waiting to be processed
+	struct Chunk
+	{
+		uint begin;
+		uint end;
+	};
+	// Each thread takes chunks from the back of its own queue and steals
+	// from the front of the others' queues when its own is empty
+	struct WorkQueue
+	{
+		mutex lock;
+		deque< Chunk > chunks;
+	};
+
+	void WorkerMain(uint thread);
+	void RunChunks(uint thread);
+	bool TakeChunk(uint thread, Chunk& chunk);
+
+	// One queue per thread, the calling thread being thread 0
+	vector< WorkQueue* > mQueues;
+	vector< thread > mWorkers;
+
+	// Job being run and the number of its chunks not yet finished
+	const RangeJob* mJob;
+	atomic< uint > mNumChunksLeft;
+	atomic< uint > mNumSteals;
+
+	// Workers sleep until the generation changes, when a new job has been queued
+	mutex mWakeLock;
+	condition_variable mWake;
+	condition_variable mDone;
+	uint mGeneration;
+	bool mStopping;
+};
+
+#endif
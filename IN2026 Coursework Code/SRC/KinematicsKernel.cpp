@@ -0,0 +1,210 @@
+#include "GameUtil.h"
+#include "KinematicsKernel.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define KINEMATICS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX instructions in functions that ask for them
+#if defined(KINEMATICS_X86) && defined(__GNUC__)
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define TARGET_AVX
+#endif
+
+// The vector kernels treat arrays of vectors as tightly packed floats
+static_assert(sizeof(GLVector3f) == 3 * sizeof(float), "GLVector3f must be three packed floats");
+
+/** Fill per-float wrap parameters for a run of packed xyz components starting at component zero. */
+static void FillWrapPattern(float* w, float* lo, float* inv, int count, float width, float height)
+{
+	for (int i = 0; i < count; i++) {
+		float size = (i % 3 == 0) ? width : ((i % 3 == 1) ? height : 0.0f);
+		w[i] = size;
+		lo[i] = -size / 2;
+		inv[i] = (size > 0) ? 1.0f / size : 0.0f;
+	}
+}
+
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////
+
+/** Integrate one body at a time. */
+void IntegrateKinematicsScalar(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height)
+{
+	float w[3], lo[3], inv[3];
+	FillWrapPattern(w, lo, inv, 3, width, height);
+	float* pf = (float*)p;
+	float* vf = (float*)v;
+	const float* af = (const float*)a;
+	for (uint i = 0; i < 3 * n; i += 3) {
+		for (int k = 0; k < 3; k++) {
+			float pk = pf[i + k] + vf[i + k] * dt;
+			vf[i + k] += af[i + k] * dt;
+			pf[i + k] = pk - w[k] * floor((pk - lo[k]) * inv[k]);
+		}
+	}
+}
+
+#ifdef KINEMATICS_X86
+
+/** Round down, valid for values within the range of a 32-bit integer. */
+static inline __m128 FloorSSE2(__m128 x)
+{
+	__m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+	return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+/** Integrate four bodies at a time as three vectors of four packed floats. */
+void IntegrateKinematicsSSE2(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height)
+{
+	float w[12], lo[12], inv[12];
+	FillWrapPattern(w, lo, inv, 12, width, height);
+	float* pf = (float*)p;
+	float* vf = (float*)v;
+	const float* af = (const float*)a;
+	__m128 dtv = _mm_set1_ps(dt);
+	uint i = 0;
+	for (; i + 4 <= n; i += 4) {
+		for (int k = 0; k < 3; k++) {
+			uint offset = 3 * i + 4 * k;
+			__m128 pv = _mm_loadu_ps(pf + offset);
+			__m128 vv = _mm_loadu_ps(vf + offset);
+			__m128 av = _mm_loadu_ps(af + offset);
+			pv = _mm_add_ps(pv, _mm_mul_ps(vv, dtv));
+			vv = _mm_add_ps(vv, _mm_mul_ps(av, dtv));
+			__m128 f = FloorSSE2(_mm_mul_ps(_mm_sub_ps(pv, _mm_loadu_ps(lo + 4 * k)), _mm_loadu_ps(inv + 4 * k)));
+			pv = _mm_sub_ps(pv, _mm_mul_ps(_mm_loadu_ps(w + 4 * k), f));
+			_mm_storeu_ps(pf + offset, pv);
+			_mm_storeu_ps(vf + offset, vv);
+		}
+	}
+	// Integrate any remaining bodies one at a time
+	IntegrateKinematicsScalar(p + i, v + i, a + i, n - i, dt, width, height);
+}
+
+/** Integrate eight bodies at a time as three vectors of eight packed floats. */
+TARGET_AVX void IntegrateKinematicsAVX(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height)
+{
+	float w[24], lo[24], inv[24];
+	FillWrapPattern(w, lo, inv, 24, width, height);
+	float* pf = (float*)p;
+	float* vf = (float*)v;
+	const float* af = (const float*)a;
+	__m256 dtv = _mm256_set1_ps(dt);
+	uint i = 0;
+	for (; i + 8 <= n; i += 8) {
+		for (int k = 0; k < 3; k++) {
+			uint offset = 3 * i + 8 * k;
+			__m256 pv = _mm256_loadu_ps(pf + offset);
+			__m256 vv = _mm256_loadu_ps(vf + offset);
+			__m256 av = _mm256_loadu_ps(af + offset);
+			pv = _mm256_add_ps(pv, _mm256_mul_ps(vv, dtv));
+			vv = _mm256_add_ps(vv, _mm256_mul_ps(av, dtv));
+			__m256 f = _mm256_floor_ps(_mm256_mul_ps(_mm256_sub_ps(pv, _mm256_loadu_ps(lo + 8 * k)), _mm256_loadu_ps(inv + 8 * k)));
+			pv = _mm256_sub_ps(pv, _mm256_mul_ps(_mm256_loadu_ps(w + 8 * k), f));
+			_mm256_storeu_ps(pf + offset, pv);
+			_mm256_storeu_ps(vf + offset, vv);
+		}
+	}
+	// Clear the upper halves of the AVX registers before running SSE code, or every
+	// SSE instruction after this pays for a state transition
+	_mm256_zeroupper();
+	// Integrate any remaining bodies one at a time
+	IntegrateKinematicsScalar(p + i, v + i, a + i, n - i, dt, width, height);
+}
+
+/** Check the processor for SSE2, and for AVX with the OS saving its registers. */
+static void GetProcessorFeatures(bool& sse2, bool& avx)
+{
+	uint ecx = 0, edx = 0;
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	ecx = (uint)info[2];
+	edx = (uint)info[3];
+#else
+	uint eax, ebx;
+	__get_cpuid(1, &eax, &ebx, &ecx, &edx);
+#endif
+	sse2 = (edx & (1 << 26)) != 0;
+	avx = false;
+	if ((ecx & (1 << 27)) && (ecx & (1 << 28))) {
+#if defined(_MSC_VER)
+		unsigned long long xcr0 = _xgetbv(0);
+#else
+		uint xcr0_lo, xcr0_hi;
+		__asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		unsigned long long xcr0 = xcr0_lo;
+#endif
+		avx = (xcr0 & 6) == 6;
+	}
+}
+
+#else
+
+/** Vector kernels fall back to the scalar kernel on other processors. */
+void IntegrateKinematicsSSE2(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height)
+{
+	IntegrateKinematicsScalar(p, v, a, n, dt, width, height);
+}
+
+void IntegrateKinematicsAVX(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height)
+{
+	IntegrateKinematicsScalar(p, v, a, n, dt, width, height);
+}
+
+static void GetProcessorFeatures(bool& sse2, bool& avx)
+{
+	sse2 = false;
+	avx = false;
+}
+
+#endif
+
+/** Choose the fastest kernel this processor supports. */
+static KinematicsKernel ChooseKinematicsKernel()
+{
+	if (IsKinematicsKernelSupported(IntegrateKinematicsAVX)) return IntegrateKinematicsAVX;
+	if (IsKinematicsKernelSupported(IntegrateKinematicsSSE2)) return IntegrateKinematicsSSE2;
+	return IntegrateKinematicsScalar;
+}
+
+// The kernel is chosen once at startup
+static KinematicsKernel sKernel = ChooseKinematicsKernel();
+
+/** Check whether a kernel can run on this processor. */
+bool IsKinematicsKernelSupported(KinematicsKernel kernel)
+{
+	bool sse2, avx;
+	GetProcessorFeatures(sse2, avx);
+	if (kernel == IntegrateKinematicsAVX) return avx;
+	if (kernel == IntegrateKinematicsSSE2) return sse2;
+	return kernel == IntegrateKinematicsScalar;
+}
+
+/** Get the kernel in use. */
+KinematicsKernel GetKinematicsKernel()
+{
+	return sKernel;
+}
+
+/** Override the kernel in use, ignoring kernels this processor cannot run. */
+void SetKinematicsKernel(KinematicsKernel kernel)
+{
+	if (IsKinematicsKernelSupported(kernel)) sKernel = kernel;
+}
+
+/** Get a printable name for a kernel. */
+const char* GetKinematicsKernelName(KinematicsKernel kernel)
+{
+	if (kernel == IntegrateKinematicsAVX) return "AVX";
+	if (kernel == IntegrateKinematicsSSE2) return "SSE2";
+	if (kernel == IntegrateKinematicsScalar) return "Scalar";
+	return "Unknown";
+}
@@ -0,0 +1,22 @@
+#ifndef __KINEMATICSKERNEL_H__
+#define __KINEMATICSKERNEL_H__
+
+#include "GameUtil.h"
+
+// Integrates n bodies over dt seconds, p += v*dt then v += a*dt, and wraps the
+// x and y of each position into [-width/2, width/2) and [-height/2, height/2)
+typedef void (*KinematicsKernel)(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height);
+
+void IntegrateKinematicsScalar(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height);
+void IntegrateKinematicsSSE2(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height);
+void IntegrateKinematicsAVX(GLVector3f* p, GLVector3f* v, const GLVector3f* a, uint n, float dt, float width, float height);
+
+// Kernels supported by this processor, so callers can fall back or compare
+bool IsKinematicsKernelSupported(KinematicsKernel kernel);
+
+// The kernel used by the engine, by default the fastest one this processor supports
+KinematicsKernel GetKinematicsKernel();
+void SetKinematicsKernel(KinematicsKernel kernel);
+const char* GetKinematicsKernelName(KinematicsKernel kernel);
+
+#endif
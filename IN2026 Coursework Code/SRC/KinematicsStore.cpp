@@ -0,0 +1,95 @@
+#include "GameUtil.h"
+#include "KinematicsStore.h"
+#include "KinematicsKernel.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+KinematicsStore::KinematicsStore(void)
+{
+}
+
+/** Destructor. */
+KinematicsStore::~KinematicsStore(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Add a body with given position, velocity, acceleration, angle and rotation, returning its slot. */
+uint KinematicsStore::Add(const GLVector3f& p, const GLVector3f& v, const GLVector3f& a, GLfloat h, GLfloat r)
+{
+	// Reuse a removed slot if there is one
+	if (!mFreeSlots.empty()) {
+		uint slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		mPositions[slot] = p;
+		mVelocities[slot] = v;
+		mAccelerations[slot] = a;
+		mAngles[slot] = h;
+		mRotations[slot] = r;
+		mPreviousPositions[slot] = p;
+		mPreviousAngles[slot] = h;
+		return slot;
+	}
+	mPositions.push_back(p);
+	mVelocities.push_back(v);
+	mAccelerations.push_back(a);
+	mAngles.push_back(h);
+	mRotations.push_back(r);
+	mPreviousPositions.push_back(p);
+	mPreviousAngles.push_back(h);
+	return (uint)(mPositions.size() - 1);
+}
+
+/** Remove the body in a slot. The slot stays in the arrays, at rest, until it is reused. */
+void KinematicsStore::Remove(uint slot)
+{
+	mPositions[slot] = GLVector3f(0, 0, 0);
+	mVelocities[slot] = GLVector3f(0, 0, 0);
+	mAccelerations[slot] = GLVector3f(0, 0, 0);
+	mAngles[slot] = 0;
+	mRotations[slot] = 0;
+	mPreviousPositions[slot] = GLVector3f(0, 0, 0);
+	mPreviousAngles[slot] = 0;
+	mFreeSlots.push_back(slot);
+}
+
+/** Remove all bodies. */
+void KinematicsStore::Clear()
+{
+	mPositions.clear();
+	mVelocities.clear();
+	mAccelerations.clear();
+	mAngles.clear();
+	mRotations.clear();
+	mPreviousPositions.clear();
+	mPreviousAngles.clear();
+	mFreeSlots.clear();
+}
+
+/** Update angle, position and velocity of every body, then wrap positions
+	onto a world of the given size without looping. */
+void KinematicsStore::Integrate(int t, float width, float height)
+{
+	// Calculate seconds since last update
+	float dt = t / 1000.0f;
+
+	uint n = (uint)mPositions.size();
+	if (n == 0) return;
+	for (uint i = 0; i < n; i++) {
+		// Update angle, keeping it within [0, 360)
+		GLfloat angle = mAngles[i] + mRotations[i] * dt;
+		mAngles[i] = angle - 360.0f * floor(angle / 360.0f);
+	}
+	// Update positions and velocities with the fastest kernel for this processor
+	GetKinematicsKernel()(&mPositions[0], &mVelocities[0], &mAccelerations[0], n, dt, width, height);
+}
+
+/** Keep the position and angle of every body as they are before a step, copying
+	whole arrays rather than visiting each body's object. */
+void KinematicsStore::StorePreviousState()
+{
+	mPreviousPositions = mPositions;
+	mPreviousAngles = mAngles;
+}
@@ -0,0 +1,54 @@
+#ifndef __KINEMATICSSTORE_H__
+#define __KINEMATICSSTORE_H__
+
+#include "GameUtil.h"
+#include <vector>
+
+class KinematicsStore
+{
+public:
+	KinematicsStore(void);
+	~KinematicsStore(void);
+
+	uint Add(const GLVector3f& p, const GLVector3f& v, const GLVector3f& a, GLfloat h, GLfloat r);
+	void Remove(uint slot);
+	void Clear();
+
+	void Integrate(int t, float width, float height);
+	void StorePreviousState();
+
+	GLVector3f& Position(uint slot) { return mPositions[slot]; }
+	GLVector3f& Velocity(uint slot) { return mVelocities[slot]; }
+	GLVector3f& Acceleration(uint slot) { return mAccelerations[slot]; }
+	GLfloat& Angle(uint slot) { return mAngles[slot]; }
+	GLfloat& Rotation(uint slot) { return mRotations[slot]; }
+	GLVector3f& PreviousPosition(uint slot) { return mPreviousPositions[slot]; }
+	GLfloat& PreviousAngle(uint slot) { return mPreviousAngles[slot]; }
+
+	const GLVector3f& Position(uint slot) const { return mPositions[slot]; }
+	const GLVector3f& Velocity(uint slot) const { return mVelocities[slot]; }
+	const GLVector3f& Acceleration(uint slot) const { return mAccelerations[slot]; }
+	GLfloat Angle(uint slot) const { return mAngles[slot]; }
+	GLfloat Rotation(uint slot) const { return mRotations[slot]; }
+	const GLVector3f& PreviousPosition(uint slot) const { return mPreviousPositions[slot]; }
+	GLfloat PreviousAngle(uint slot) const { return mPreviousAngles[slot]; }
+
+	uint GetNumSlots() const { return (uint)mPositions.size(); }
+	uint GetNumBodies() const { return (uint)(mPositions.size() - mFreeSlots.size()); }
+
+protected:
+	// Contiguous kinematic state, one entry per slot
+	vector< GLVector3f > mPositions;
+	vector< GLVector3f > mVelocities;
+	vector< GLVector3f > mAccelerations;
+	vector< GLfloat > mAngles;
+	vector< GLfloat > mRotations;
+	// Position and angle of each body before the last step
+	vector< GLVector3f > mPreviousPositions;
+	vector< GLfloat > mPreviousAngles;
+
+	// Slots that have been removed and can be reused
+	vector< uint > mFreeSlots;
+};
+
+#endif
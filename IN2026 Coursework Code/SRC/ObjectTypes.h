@@ -0,0 +1,12 @@
+#ifndef __OBJECTTYPES_H__
+#define __OBJECTTYPES_H__
+
+#include "GameObjectType.h"
+
+// Types of the objects in an asteroids game, hashed at compile time
+constexpr GameObjectType ASTEROID_TYPE = "Asteroid"_type;
+constexpr GameObjectType BULLET_TYPE = "Bullet"_type;
+constexpr GameObjectType SPACESHIP_TYPE = "Spaceship"_type;
+constexpr GameObjectType EXPLOSION_TYPE = "Explosion"_type;
+
+#endif
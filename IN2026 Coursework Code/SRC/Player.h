@@ -5,8 +5,10 @@
 
 #include "GameObject.h"
 #include "GameObjectType.h"
+#include "ObjectTypes.h"
 #include "IPlayerListener.h"
 #include "IGameWorldListener.h"
+#include "StateStream.h"
 
 class Player : public IGameWorldListener
 {
@@ -20,12 +22,18 @@ public:
 
 	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
 	{
-		if (object->GetType() == GameObjectType("Spaceship")) {
+		if (object->GetType() == SPACESHIP_TYPE) {
 			mLives -= 1;
 			FirePlayerKilled();
 		}
 	}
 
+	int GetLives() const { return mLives; }
+
+	// Listeners are not told of restored lives, as no life has been lost
+	void SaveState(StateWriter& writer) const { writer.Write(mLives); }
+	void RestoreState(StateReader& reader) { reader.Read(mLives); }
+
 	void AddListener(shared_ptr<IPlayerListener> listener)
 	{
 		mListeners.push_back(listener);
@@ -0,0 +1,108 @@
+#include "GameUtil.h"
+#include "Random.h"
+#include "StateStream.h"
+
+/** Rotate the bits of x left by k places. */
+static inline uint RotateLeft(uint x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+/** Advance a splitmix64 counter and get its next mixed output. */
+static inline unsigned long long SplitMix64(unsigned long long& x)
+{
+	unsigned long long z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Constructor. Seeds the generator for the given substream of the given seed. */
+Random::Random(uint seed, uint stream)
+{
+	Seed(seed, stream);
+}
+
+/** Destructor. */
+Random::~Random(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Reset the generator to the start of the given substream of the given seed.
+	The state is mixed from the pair, so nearby seeds and streams are unrelated. */
+void Random::Seed(uint seed, uint stream)
+{
+	mSeed = seed;
+	mStream = stream;
+	unsigned long long x = ((unsigned long long)seed << 32) | stream;
+	unsigned long long a = SplitMix64(x);
+	unsigned long long b = SplitMix64(x);
+	mState[0] = (uint)a;
+	mState[1] = (uint)(a >> 32);
+	mState[2] = (uint)b;
+	mState[3] = (uint)(b >> 32);
+	if ((mState[0] | mState[1] | mState[2] | mState[3]) == 0) mState[0] = 1;
+}
+
+/** Get a generator for another substream of this generator's seed. It does not
+	depend on how far this generator has advanced. */
+Random Random::GetSubstream(uint stream) const
+{
+	return Random(mSeed, stream);
+}
+
+/** Get the next 32 random bits. */
+uint Random::Next()
+{
+	uint result = RotateLeft(mState[1] * 5, 7) * 9;
+	uint t = mState[1] << 9;
+	mState[2] ^= mState[0];
+	mState[3] ^= mState[1];
+	mState[1] ^= mState[2];
+	mState[0] ^= mState[3];
+	mState[2] ^= t;
+	mState[3] = RotateLeft(mState[3], 11);
+	return result;
+}
+
+/** Get a random integer from 0 up to but not including n. */
+uint Random::Next(uint n)
+{
+	// Scale rather than take a remainder, which needs no division and has a
+	// bias of at most n in 2^32
+	return (uint)(((unsigned long long)Next() * n) >> 32);
+}
+
+/** Get a random float from 0 up to but not including 1. */
+float Random::NextFloat()
+{
+	// The top 24 bits fill the mantissa exactly
+	return (Next() >> 8) * (1.0f / 16777216.0f);
+}
+
+/** Get a random float from min up to but not including max. */
+float Random::NextFloat(float min, float max)
+{
+	return min + (max - min) * NextFloat();
+}
+
+/** Save how far the generator has advanced, and the seed and stream it started from. */
+void Random::SaveState(StateWriter& writer) const
+{
+	for (int i = 0; i < 4; i++) writer.Write(mState[i]);
+	writer.Write(mSeed);
+	writer.Write(mStream);
+}
+
+/** Restore the generator to a saved state, to draw the same numbers again. */
+void Random::RestoreState(StateReader& reader)
+{
+	for (int i = 0; i < 4; i++) reader.Read(mState[i]);
+	reader.Read(mSeed);
+	reader.Read(mStream);
+	if ((mState[0] | mState[1] | mState[2] | mState[3]) == 0) mState[0] = 1;
+}
@@ -0,0 +1,38 @@
+#ifndef __RANDOM_H__
+#define __RANDOM_H__
+
+#include "GameUtil.h"
+
+class StateWriter;
+class StateReader;
+
+class Random
+{
+public:
+	Random(uint seed = 0, uint stream = 0);
+	~Random(void);
+
+	void Seed(uint seed, uint stream = 0);
+	uint GetSeed() const { return mSeed; }
+	uint GetStream() const { return mStream; }
+
+	Random GetSubstream(uint stream) const;
+
+	uint Next();
+	uint Next(uint n);
+	float NextFloat();
+	float NextFloat(float min, float max);
+
+	void SaveState(StateWriter& writer) const;
+	void RestoreState(StateReader& reader);
+
+protected:
+	// xoshiro128** state, never all zero
+	uint mState[4];
+
+	// The seed and stream the state was derived from
+	uint mSeed;
+	uint mStream;
+};
+
+#endif
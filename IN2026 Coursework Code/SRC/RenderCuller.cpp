@@ -0,0 +1,38 @@
+#include <algorithm>
+#include "GameUtil.h"
+#include "RenderCuller.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+RenderCuller::RenderCuller(void)
+	: mNumProxiesTested(0)
+{
+}
+
+/** Destructor. */
+RenderCuller::~RenderCuller(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Find the proxies whose circles overlap the view from (left, bottom) to (right, top),
+	returning their indices in order. Proxies with a negative radius are always visible.
+	The proxies are rebuilt every frame, so one pass testing each of them in turn is
+	cheaper than first bucketing them into regions of the world to skip. */
+void RenderCuller::Cull(const BroadphaseProxyList& proxies,
+	float left, float bottom, float right, float top, vector< uint >& visible)
+{
+	visible.clear();
+	uint n = (uint)proxies.size();
+	for (uint i = 0; i < n; i++) {
+		const BroadphaseProxy& proxy = proxies[i];
+		if (proxy.radius >= 0) {
+			if (proxy.x + proxy.radius < left || proxy.x - proxy.radius > right) continue;
+			if (proxy.y + proxy.radius < bottom || proxy.y - proxy.radius > top) continue;
+		}
+		visible.push_back(i);
+	}
+	mNumProxiesTested = n;
+}
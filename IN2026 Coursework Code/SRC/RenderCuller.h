@@ -0,0 +1,24 @@
+#ifndef __RENDERCULLER_H__
+#define __RENDERCULLER_H__
+
+#include "GameUtil.h"
+#include "IBroadphase.h"
+#include <vector>
+
+class RenderCuller
+{
+public:
+	RenderCuller(void);
+	~RenderCuller(void);
+
+	void Cull(const BroadphaseProxyList& proxies,
+		float left, float bottom, float right, float top, vector< uint >& visible);
+
+	uint GetNumProxiesTested() const { return mNumProxiesTested; }
+
+protected:
+	// Proxies tested against the view in the last cull
+	uint mNumProxiesTested;
+};
+
+#endif
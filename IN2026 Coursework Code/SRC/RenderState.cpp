@@ -0,0 +1,93 @@
+#include "GameUtil.h"
+#include "RenderState.h"
+
+// PRIVATE INSTANCE CONSTRUCTORS //////////////////////////////////////////////
+
+/** Constructor. Nothing is known about the GL state until it is first set. */
+RenderState::RenderState()
+	: mNumStateChanges(0),
+	  mNumRedundantChanges(0),
+	  mNumStateChangesLastFrame(0),
+	  mNumRedundantChangesLastFrame(0)
+{
+	Reset();
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Forget the cached state, so that the next change to each state is made
+	whatever it is. Call this after changing any of the state directly. */
+void RenderState::Reset()
+{
+	mLighting = -1;
+	mBlending = -1;
+	mTexturing = -1;
+	mBlendFuncKnown = false;
+	mTextureKnown = false;
+	mColourKnown = false;
+}
+
+/** Start counting state changes for a new frame. */
+void RenderState::BeginFrame()
+{
+	mNumStateChangesLastFrame = mNumStateChanges;
+	mNumRedundantChangesLastFrame = mNumRedundantChanges;
+	mNumStateChanges = 0;
+	mNumRedundantChanges = 0;
+}
+
+/** Set the factors used to blend, if they are not set already. */
+void RenderState::SetBlendFunc(GLenum src, GLenum dst)
+{
+	if (mBlendFuncKnown && mBlendSrc == src && mBlendDst == dst) { mNumRedundantChanges++; return; }
+	glBlendFunc(src, dst);
+	mBlendFuncKnown = true;
+	mBlendSrc = src;
+	mBlendDst = dst;
+	mNumStateChanges++;
+}
+
+/** Bind a 2D texture, if it is not bound already. */
+void RenderState::BindTexture(GLuint texture_id)
+{
+	if (mTextureKnown && mTextureID == texture_id) { mNumRedundantChanges++; return; }
+	glBindTexture(GL_TEXTURE_2D, texture_id);
+	mTextureKnown = true;
+	mTextureID = texture_id;
+	mNumStateChanges++;
+}
+
+/** Set the current colour, if it is not set already. */
+void RenderState::SetColour(GLfloat r, GLfloat g, GLfloat b)
+{
+	if (mColourKnown && mColour[0] == r && mColour[1] == g && mColour[2] == b) { mNumRedundantChanges++; return; }
+	glColor3f(r, g, b);
+	mColourKnown = true;
+	mColour[0] = r;
+	mColour[1] = g;
+	mColour[2] = b;
+	mNumStateChanges++;
+}
+
+/** Set the state sprites are drawn with: alpha blended, textured and lit by the
+	scene's white light, so the colour last used for lines does not tint them. */
+void RenderState::SetSpriteState(GLuint texture_id)
+{
+	SetLighting(true);
+	SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	SetBlending(true);
+	SetTexturing(true);
+	BindTexture(texture_id);
+}
+
+// PRIVATE INSTANCE METHODS ///////////////////////////////////////////////////
+
+/** Enable or disable a capability, if it is not in that state already. */
+void RenderState::SetCapability(GLenum capability, bool enabled, int& cached)
+{
+	if (cached == (enabled ? 1 : 0)) { mNumRedundantChanges++; return; }
+	if (enabled) glEnable(capability);
+	else glDisable(capability);
+	cached = enabled ? 1 : 0;
+	mNumStateChanges++;
+}
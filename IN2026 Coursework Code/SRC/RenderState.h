@@ -0,0 +1,58 @@
+#ifndef __RENDERSTATE_H__
+#define __RENDERSTATE_H__
+
+#include "GameUtil.h"
+
+class RenderState
+{
+public:
+	inline static RenderState& GetInstance(void)
+	{
+		static RenderState mInstance;
+		return mInstance;
+	}
+
+	void Reset();
+	void BeginFrame();
+
+	void SetLighting(bool enabled) { SetCapability(GL_LIGHTING, enabled, mLighting); }
+	void SetBlending(bool enabled) { SetCapability(GL_BLEND, enabled, mBlending); }
+	void SetTexturing(bool enabled) { SetCapability(GL_TEXTURE_2D, enabled, mTexturing); }
+	void SetBlendFunc(GLenum src, GLenum dst);
+	void BindTexture(GLuint texture_id);
+	void SetColour(GLfloat r, GLfloat g, GLfloat b);
+	void SetSpriteState(GLuint texture_id);
+
+	uint GetNumStateChanges() const { return mNumStateChanges; }
+	uint GetNumRedundantChanges() const { return mNumRedundantChanges; }
+	uint GetNumStateChangesLastFrame() const { return mNumStateChangesLastFrame; }
+	uint GetNumRedundantChangesLastFrame() const { return mNumRedundantChangesLastFrame; }
+
+private:
+	RenderState(); // Private constructor
+	~RenderState() {} // Private destructor
+
+	void SetCapability(GLenum capability, bool enabled, int& cached);
+
+	// Whether each capability is enabled, or -1 if not known
+	int mLighting;
+	int mBlending;
+	int mTexturing;
+
+	// Blend factors, texture and colour last set, if known
+	bool mBlendFuncKnown;
+	GLenum mBlendSrc;
+	GLenum mBlendDst;
+	bool mTextureKnown;
+	GLuint mTextureID;
+	bool mColourKnown;
+	GLfloat mColour[3];
+
+	// Changes made and changes dropped as redundant this frame and last frame
+	uint mNumStateChanges;
+	uint mNumRedundantChanges;
+	uint mNumStateChangesLastFrame;
+	uint mNumRedundantChangesLastFrame;
+};
+
+#endif
@@ -5,8 +5,10 @@
 
 #include "GameObject.h"
 #include "GameObjectType.h"
+#include "ObjectTypes.h"
 #include "IScoreListener.h"
 #include "IGameWorldListener.h"
+#include "StateStream.h"
 
 class ScoreKeeper : public IGameWorldListener
 {
@@ -19,12 +21,18 @@ public:
 
 	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object)
 	{
-		if (object->GetType() == GameObjectType("Asteroid")) {
+		if (object->GetType() == ASTEROID_TYPE) {
  			mScore += 10;
 			FireScoreChanged();
 		}
 	}
 
+	int GetScore() const { return mScore; }
+
+	// Listeners are not told of a restored score, as it is not a change in the game
+	void SaveState(StateWriter& writer) const { writer.Write(mScore); }
+	void RestoreState(StateReader& reader) { reader.Read(mScore); }
+
 	void AddListener(shared_ptr<IScoreListener> listener)
 	{
 		mListeners.push_back(listener);
@@ -1,39 +1,58 @@
 #include "GameUtil.h"
 #include "Shape.h"
+#include "RenderState.h"
 
 using namespace std;
 
 Shape::Shape()
+	: mLoop(false),
+	  mRadius(0),
+	  mDisplayList(0)
 {
 }
 
 Shape::Shape(const string& shape_filename)
+	: mLoop(false),
+	  mRadius(0),
+	  mDisplayList(0)
 {
 	LoadShape(shape_filename);
 }
 
 Shape::~Shape()
 {
+	if (mDisplayList != 0) glDeleteLists(mDisplayList, 1);
 }
 
 void Shape::Render(void)
 {
+	// Compile the shape once rather than sending every vertex every frame. This is
+	// left until rendering as shapes can be loaded before there is a GL context.
+	if (mDisplayList == 0) CompileDisplayList();
+	// Set state through the cache, outside the list, so repeated shapes do not reset it
+	RenderState& state = RenderState::GetInstance();
 	// Disable lighting for solid colour lines
-	glDisable(GL_LIGHTING);
+	state.SetLighting(false);
+	state.SetTexturing(false);
+	state.SetBlending(false);
+	state.SetColour(mRGB[0], mRGB[1], mRGB[2]);
+	glCallList(mDisplayList);
+}
+
+void Shape::CompileDisplayList(void)
+{
+	mDisplayList = glGenLists(1);
+	glNewList(mDisplayList, GL_COMPILE);
 	// Start drawing lines
 	if (mLoop) { glBegin(GL_LINE_LOOP); }
 	else { glBegin(GL_LINE_STRIP); }
-	// Set rgb colour
-	glColor3f(mRGB[0], mRGB[1], mRGB[2]);
 	// Add vertices to draw shape
-	for (GLVector2fList::iterator it = mPoints.begin(); it != mPoints.end(); ++it) {
-		shared_ptr<GLVector2f> vec = (*it);
-		glVertex2f(vec->x, vec->y);
+	for (GLVector2fVector::iterator it = mPoints.begin(); it != mPoints.end(); ++it) {
+		glVertex2f(it->x, it->y);
 	}
 	// Finish drawing lines
 	glEnd();
-	// Enable lighting
-	glEnable(GL_LIGHTING);
+	glEndList();
 
 }
 
@@ -51,11 +70,16 @@ void Shape::LoadShape(const string& shape_filename)
 	else { mLoop = false; }
 
 	shape_file >> mRGB;
-	while (!shape_file.eof()) {
-		float x, y;
-		shape_file >> x >> y;
-		shared_ptr<GLVector2f> vec(new GLVector2f(x, y));
-		mPoints.push_back(vec);
+	mPoints.clear();
+	mRadius = 0;
+	float x, y;
+	while (shape_file >> x >> y) {
+		mPoints.push_back(GLVector2f(x, y));
+		mRadius = max(mRadius, sqrt(x * x + y * y));
 	}
 
+	// Recompile with the new points when next rendered
+	if (mDisplayList != 0) glDeleteLists(mDisplayList, 1);
+	mDisplayList = 0;
+
 }
@@ -2,10 +2,11 @@
 #define __SHAPE_H__
 
 #include "GameUtil.h"
+#include <vector>
 
 using namespace std;
 
-typedef list< shared_ptr<GLVector2f> > GLVector2fList;
+typedef vector< GLVector2f > GLVector2fVector;
 	
 class Shape
 {
@@ -19,12 +20,21 @@ public:
 	void LoadShape(const string& shape_filename);
 
 	const GLVector3f& GetRGBColour() { return mRGB; }
-	const GLVector2fList& GetPoints() { return mPoints; } 
+	const GLVector2fVector& GetPoints() { return mPoints; } 
+	bool IsLoop() { return mLoop; }
+	GLfloat GetRadius() { return mRadius; }
 
 private:
+	void CompileDisplayList(void);
+
 	bool mLoop;
 	GLVector3f mRGB;
-	GLVector2fList mPoints;
+	GLVector2fVector mPoints;
+	// Distance from the origin to the furthest point
+	GLfloat mRadius;
+
+	// Display list drawing the shape, compiled the first time it is rendered
+	GLuint mDisplayList;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <atomic>
+#include <string.h>
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "SnapshotRing.h"
+#include "WorldSnapshot.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/** Write a field low byte first, whatever the byte order of the machine. */
+static inline void StoreLittleEndian(uchar* p, uint value)
+{
+	p[0] = (uchar)value;
+	p[1] = (uchar)(value >> 8);
+	p[2] = (uchar)(value >> 16);
+	p[3] = (uchar)(value >> 24);
+}
+
+/** Read a field written by StoreLittleEndian. */
+static inline uint LoadLittleEndian(const uchar* p)
+{
+	return (uint)p[0] | ((uint)p[1] << 8) | ((uint)p[2] << 16) | ((uint)p[3] << 24);
+}
+
+/** Read a sequence number that another process may be writing. */
+static inline unsigned long long LoadSequence(const uchar* p)
+{
+	unsigned long long sequence = *(const volatile unsigned long long*)p;
+	atomic_thread_fence(memory_order_acquire);
+	return sequence;
+}
+
+/** Write a sequence number once everything written before it is visible. */
+static inline void StoreSequence(uchar* p, unsigned long long sequence)
+{
+	atomic_thread_fence(memory_order_release);
+	*(volatile unsigned long long*)p = sequence;
+}
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+SnapshotRing::SnapshotRing(void)
+	: mData(NULL),
+	  mDataSize(0),
+	  mSlotSize(0),
+	  mNumSlots(0),
+	  mSequence(0),
+	  mNumTruncated(0),
+#if defined(_WIN32)
+	  mFile(INVALID_HANDLE_VALUE),
+	  mMapping(NULL)
+#else
+	  mFile(-1)
+#endif
+{
+}
+
+/** Destructor. */
+SnapshotRing::~SnapshotRing(void)
+{
+	Close();
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Create a file of num_slots slots, each holding a snapshot of up to slot_size
+	bytes, and map it into memory. Other processes can map the same file and read
+	the latest snapshots while the ring is written. The ring must also be added to
+	a world as a listener, to write a snapshot of it at the end of every tick. */
+bool SnapshotRing::Open(const string& filename, uint slot_size, uint num_slots)
+{
+	Close();
+	if (slot_size < SNAPSHOT_HEADER_SIZE || num_slots == 0) return false;
+	mSlotSize = (slot_size + 7) & ~7u;
+	mNumSlots = num_slots;
+	mDataSize = SNAPSHOT_RING_HEADER_SIZE + (size_t)num_slots * (SNAPSHOT_SLOT_HEADER_SIZE + mSlotSize);
+
+#if defined(_WIN32)
+	mFile = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+		NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (mFile == INVALID_HANDLE_VALUE) { Close(); return false; }
+	unsigned long long size = mDataSize;
+	mMapping = CreateFileMappingA(mFile, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+	if (mMapping == NULL) { Close(); return false; }
+	mData = (uchar*)MapViewOfFile(mMapping, FILE_MAP_ALL_ACCESS, 0, 0, mDataSize);
+	if (mData == NULL) { Close(); return false; }
+#else
+	mFile = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (mFile < 0 || ftruncate(mFile, (off_t)mDataSize) != 0) { Close(); return false; }
+	void* data = mmap(NULL, mDataSize, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0);
+	if (data == MAP_FAILED) { Close(); return false; }
+	mData = (uchar*)data;
+#endif
+
+	// The file starts zeroed, so every slot reads as empty
+	mSequence = 0;
+	mNumTruncated = 0;
+	StoreLittleEndian(mData, SNAPSHOT_RING_MAGIC);
+	StoreLittleEndian(mData + 4, SNAPSHOT_RING_VERSION);
+	StoreLittleEndian(mData + 8, mSlotSize);
+	StoreLittleEndian(mData + 12, mNumSlots);
+	StoreSequence(mData + 16, 0);
+	return true;
+}
+
+/** Unmap and close the file, which is left holding the last snapshots written. */
+void SnapshotRing::Close(void)
+{
+#if defined(_WIN32)
+	if (mData != NULL) UnmapViewOfFile(mData);
+	if (mMapping != NULL) CloseHandle(mMapping);
+	if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+	mMapping = NULL;
+	mFile = INVALID_HANDLE_VALUE;
+#else
+	if (mData != NULL) munmap(mData, mDataSize);
+	if (mFile >= 0) close(mFile);
+	mFile = -1;
+#endif
+	mData = NULL;
+	mDataSize = 0;
+}
+
+/** Write a snapshot of a world into the next slot, overwriting the oldest. The
+	slot is marked as being written first, so readers never take a half written
+	snapshot for a whole one. */
+void SnapshotRing::Write(GameWorld* world)
+{
+	if (!IsOpen()) return;
+	unsigned long long sequence = ++mSequence;
+	uchar* slot = GetSlot(sequence);
+	StoreSequence(slot, 0);
+	atomic_thread_fence(memory_order_release);
+	uint size = world->WriteSnapshot(slot + SNAPSHOT_SLOT_HEADER_SIZE, mSlotSize);
+	if (size < world->GetSnapshotSize()) mNumTruncated++;
+	StoreLittleEndian(slot + 8, size);
+	StoreSequence(slot, sequence);
+	StoreSequence(mData + 16, sequence);
+}
+
+/** Copy the latest whole snapshot into a buffer of size bytes, returning its size,
+	or 0 if there is none yet or it does not fit. */
+uint SnapshotRing::ReadLatest(uchar* buffer, uint size)
+{
+	if (!IsOpen()) return 0;
+	for (;;) {
+		unsigned long long sequence = LoadSequence(mData + 16);
+		if (sequence == 0) return 0;
+		const uchar* slot = GetSlot(sequence);
+		if (LoadSequence(slot) != sequence) continue;
+		uint snapshot_size = LoadLittleEndian(slot + 8);
+		if (snapshot_size > size || snapshot_size > mSlotSize) return 0;
+		memcpy(buffer, slot + SNAPSHOT_SLOT_HEADER_SIZE, snapshot_size);
+		// Keep the copy only if the slot was not overwritten while copying it
+		atomic_thread_fence(memory_order_acquire);
+		if (LoadSequence(slot) == sequence) return snapshot_size;
+	}
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Get the slot holding the snapshot with a sequence number. */
+uchar* SnapshotRing::GetSlot(unsigned long long sequence)
+{
+	size_t index = (size_t)((sequence - 1) % mNumSlots);
+	return mData + SNAPSHOT_RING_HEADER_SIZE + index * (SNAPSHOT_SLOT_HEADER_SIZE + mSlotSize);
+}
@@ -0,0 +1,63 @@
+#ifndef __SNAPSHOTRING_H__
+#define __SNAPSHOTRING_H__
+
+#include "GameUtil.h"
+#include "IGameWorldListener.h"
+
+class SnapshotRing : public IGameWorldListener
+{
+public:
+	SnapshotRing(void);
+	virtual ~SnapshotRing(void);
+
+	bool Open(const string& filename, uint slot_size, uint num_slots);
+	void Close(void);
+	bool IsOpen() { return mData != NULL; }
+
+	void Write(GameWorld* world);
+	uint ReadLatest(uchar* buffer, uint size);
+
+	void OnWorldUpdated(GameWorld* world) { Write(world); }
+	void OnObjectAdded(GameWorld* world, shared_ptr<GameObject> object) {}
+	void OnObjectRemoved(GameWorld* world, shared_ptr<GameObject> object) {}
+
+	uint GetSlotSize() { return mSlotSize; }
+	uint GetNumSlots() { return mNumSlots; }
+	unsigned long long GetNumWritten() { return mSequence; }
+	unsigned long long GetNumTruncated() { return mNumTruncated; }
+
+protected:
+	uchar* GetSlot(unsigned long long sequence);
+
+	// The file starts with a header holding the magic number, version, slot size,
+	// number of slots and the sequence number of the latest snapshot. Each slot
+	// then holds the sequence number of its snapshot, zero while it is being
+	// written, the size of the snapshot and the snapshot itself. Fields are
+	// little-endian, except sequence numbers, which are stored in one go in the
+	// machine's byte order for the processes on it that share the ring
+	uchar* mData;
+	size_t mDataSize;
+	uint mSlotSize;
+	uint mNumSlots;
+	// Snapshots written since the ring was opened, the first being number 1
+	unsigned long long mSequence;
+	// Snapshots missing objects because they did not fit in a slot
+	unsigned long long mNumTruncated;
+
+	// Handles of the file and its mapping
+#if defined(_WIN32)
+	void* mFile;
+	void* mMapping;
+#else
+	int mFile;
+#endif
+};
+
+// Ring files start with a magic number and version, and every slot is aligned
+// to 8 bytes so that sequence numbers can be written in one store
+const uint SNAPSHOT_RING_MAGIC = 0x474E4952; // "RING"
+const uint SNAPSHOT_RING_VERSION = 1;
+const uint SNAPSHOT_RING_HEADER_SIZE = 24;
+const uint SNAPSHOT_SLOT_HEADER_SIZE = 16;
+
+#endif
@@ -1,8 +1,12 @@
 #include "GameUtil.h"
 #include "GameWorld.h"
 #include "Bullet.h"
+#include "BulletPool.h"
 #include "Spaceship.h"
 #include "BoundingSphere.h"
+#include "CollisionLayers.h"
+#include "ObjectTypes.h"
+#include "StateStream.h"
 
 using namespace std;
 
@@ -10,19 +14,23 @@ using namespace std;
 
 /**  Default constructor. */
 Spaceship::Spaceship()
-	: GameObject("Spaceship"), mThrust(0)
+	: GameObject("Spaceship"), mThrust(0), mBulletPool(NULL)
 {
+	mCollisionLayer = COLLISION_LAYER_SPACESHIP;
+	mCollisionMask = COLLISION_LAYER_ASTEROID;
 }
 
 /** Construct a spaceship with given position, velocity, acceleration, angle, and rotation. */
 Spaceship::Spaceship(GLVector3f p, GLVector3f v, GLVector3f a, GLfloat h, GLfloat r)
-	: GameObject("Spaceship", p, v, a, h, r), mThrust(0)
+	: GameObject("Spaceship", p, v, a, h, r), mThrust(0), mBulletPool(NULL)
 {
+	mCollisionLayer = COLLISION_LAYER_SPACESHIP;
+	mCollisionMask = COLLISION_LAYER_ASTEROID;
 }
 
 /** Copy constructor. */
 Spaceship::Spaceship(const Spaceship& s)
-	: GameObject(s), mThrust(0)
+	: GameObject(s), mThrust(0), mBulletPool(NULL)
 {
 }
 
@@ -53,19 +61,31 @@ void Spaceship::Render(void)
 	GameObject::Render();
 }
 
+/** Get the radius that the spaceship's sprite and shapes lie within. */
+GLfloat Spaceship::GetRenderRadius(void)
+{
+	GLfloat radius = max(GameObject::GetRenderRadius(), 0.0f);
+	if (mSpaceshipShape.get() != NULL) radius = max(radius, mSpaceshipShape->GetRadius() * mScale);
+	if (mThrusterShape.get() != NULL) radius = max(radius, mThrusterShape->GetRadius() * mScale);
+	return radius;
+}
+
 /** Fire the rockets. */
 void Spaceship::Thrust(float t)
 {
 	mThrust = t;
 	// Increase acceleration in the direction of ship
-	mAcceleration.x = mThrust*cos(DEG2RAD*mAngle);
-	mAcceleration.y = mThrust*sin(DEG2RAD*mAngle);
+	GLfloat angle = GetAngle();
+	GLVector3f acceleration = GetAcceleration();
+	acceleration.x = mThrust*cos(DEG2RAD*angle);
+	acceleration.y = mThrust*sin(DEG2RAD*angle);
+	SetAcceleration(acceleration);
 }
 
 /** Set the rotation. */
 void Spaceship::Rotate(float r)
 {
-	mRotation = r;
+	SetRotation(r);
 }
 
 /** Shoot a bullet. */
@@ -74,18 +94,23 @@ void Spaceship::Shoot(void)
 	// Check the world exists
 	if (!mWorld) return;
 	// Construct a unit length vector in the direction the spaceship is headed
-	GLVector3f spaceship_heading(cos(DEG2RAD*mAngle), sin(DEG2RAD*mAngle), 0);
+	GLfloat angle = GetAngle();
+	GLVector3f spaceship_heading(cos(DEG2RAD*angle), sin(DEG2RAD*angle), 0);
 	spaceship_heading.normalize();
 	// Calculate the point at the node of the spaceship from position and heading
-	GLVector3f bullet_position = mPosition + (spaceship_heading * 4);
+	GLVector3f bullet_position = GetPosition() + (spaceship_heading * 4);
 	// Calculate how fast the bullet should travel
 	float bullet_speed = 30;
 	// Construct a vector for the bullet's velocity
-	GLVector3f bullet_velocity = mVelocity + spaceship_heading * bullet_speed;
-	// Construct a new bullet
-	shared_ptr<GameObject> bullet
-		(new Bullet(bullet_position, bullet_velocity, mAcceleration, mAngle, 0, 2000));
-	bullet->SetBoundingShape(make_shared<BoundingSphere>(bullet->GetThisPtr(), 2.0f));
+	GLVector3f bullet_velocity = GetVelocity() + spaceship_heading * bullet_speed;
+	// Reuse a pooled bullet if there is a pool, otherwise construct a new one
+	shared_ptr<GameObject> bullet;
+	if (mBulletPool) {
+		bullet = mBulletPool->Acquire(bullet_position, bullet_velocity, GetAcceleration(), angle, 2000);
+	} else {
+		bullet = make_shared<Bullet>(bullet_position, bullet_velocity, GetAcceleration(), angle, 0, 2000);
+		bullet->SetBoundingShape(make_shared<BoundingSphere>(bullet->GetThisPtr(), 2.0f));
+	}
 	bullet->SetShape(mBulletShape);
 	// Add the new bullet to the game world
 	mWorld->AddObject(bullet);
@@ -94,13 +119,27 @@ void Spaceship::Shoot(void)
 
 bool Spaceship::CollisionTest(shared_ptr<GameObject> o)
 {
-	if (o->GetType() != GameObjectType("Asteroid")) return false;
+	if (o->GetType() != ASTEROID_TYPE) return false;
 	if (mBoundingShape.get() == NULL) return false;
 	if (o->GetBoundingShape().get() == NULL) return false;
 	return mBoundingShape->CollisionTest(o->GetBoundingShape());
 }
 
-void Spaceship::OnCollision(const GameObjectList &objects)
+void Spaceship::OnCollision(const GameObjectSpan &objects)
 {
 	mWorld->FlagForRemoval(GetThisPtr());
+}
+
+/** Save the spaceship's state, including its thrust. */
+void Spaceship::SaveState(StateWriter& writer)
+{
+	GameObject::SaveState(writer);
+	writer.Write(mThrust);
+}
+
+/** Restore the state saved by SaveState. */
+void Spaceship::RestoreState(StateReader& reader)
+{
+	GameObject::RestoreState(reader);
+	reader.Read(mThrust);
 }
\ No newline at end of file
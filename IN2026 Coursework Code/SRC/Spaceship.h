@@ -5,6 +5,8 @@
 #include "GameObject.h"
 #include "Shape.h"
 
+class BulletPool;
+
 class Spaceship : public GameObject
 {
 public:
@@ -15,6 +17,9 @@ public:
 
 	virtual void Update(int t);
 	virtual void Render(void);
+	// Rendered itself, as its shapes are drawn beneath its sprite
+	virtual bool RenderToBatch(SpriteBatch& batch, float alpha) { return false; }
+	virtual GLfloat GetRenderRadius(void);
 
 	virtual void Thrust(float t);
 	virtual void Rotate(float r);
@@ -23,9 +28,13 @@ public:
 	void SetSpaceshipShape(shared_ptr<Shape> spaceship_shape) { mSpaceshipShape = spaceship_shape; }
 	void SetThrusterShape(shared_ptr<Shape> thruster_shape) { mThrusterShape = thruster_shape; }
 	void SetBulletShape(shared_ptr<Shape> bullet_shape) { mBulletShape = bullet_shape; }
+	void SetBulletPool(BulletPool* bullet_pool) { mBulletPool = bullet_pool; }
 
 	bool CollisionTest(shared_ptr<GameObject> o);
-	void OnCollision(const GameObjectList &objects);
+	void OnCollision(const GameObjectSpan &objects);
+
+	void SaveState(StateWriter& writer);
+	void RestoreState(StateReader& reader);
 
 private:
 	float mThrust;
@@ -33,6 +42,9 @@ private:
 	shared_ptr<Shape> mSpaceshipShape;
 	shared_ptr<Shape> mThrusterShape;
 	shared_ptr<Shape> mBulletShape;
+
+	// Pool to take bullets from, if any, rather than constructing them
+	BulletPool* mBulletPool;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include "GameUtil.h"
+#include "SpatialHash.h"
+
+// Upper limit on the number of cells along each axis of the grid
+static const int MAX_CELLS_PER_AXIS = 256;
+
+/** Wrap a cell coordinate onto a torus of n cells. */
+static inline int WrapCell(int c, int n)
+{
+	c %= n;
+	return (c < 0) ? c + n : c;
+}
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+SpatialHash::SpatialHash(void)
+	: mCellSize(0),
+	  mCellsX(1),
+	  mCellsY(1),
+	  mCellWidth(1),
+	  mCellHeight(1),
+	  mOriginX(0),
+	  mOriginY(0)
+{
+}
+
+/** Destructor. */
+SpatialHash::~SpatialHash(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Find all pairs of proxies that share at least one cell of a toroidal grid covering the world. */
+void SpatialHash::FindPairs(const BroadphaseProxyList& proxies, float width, float height, CollisionPairList& pairs)
+{
+	pairs.clear();
+	mEntries.clear();
+	if (proxies.size() < 2) return;
+
+	// Size cells so that each proxy overlaps at most two cells along each axis
+	float cell_size = mCellSize;
+	if (cell_size <= 0) {
+		for (BroadphaseProxyList::const_iterator it = proxies.begin(); it != proxies.end(); ++it) {
+			cell_size = max(cell_size, 2 * it->radius);
+		}
+	}
+
+	// Cells must tile the world exactly for the grid to wrap with it
+	mCellsX = (cell_size > 0) ? (int)(width / cell_size) : MAX_CELLS_PER_AXIS;
+	mCellsY = (cell_size > 0) ? (int)(height / cell_size) : MAX_CELLS_PER_AXIS;
+	mCellsX = min(max(mCellsX, 1), MAX_CELLS_PER_AXIS);
+	mCellsY = min(max(mCellsY, 1), MAX_CELLS_PER_AXIS);
+	mCellWidth = max(width, 1.0f) / mCellsX;
+	mCellHeight = max(height, 1.0f) / mCellsY;
+	mOriginX = -width / 2;
+	mOriginY = -height / 2;
+
+	// Insert every proxy into the cells that its bounds overlap
+	for (uint i = 0; i < proxies.size(); i++) {
+		InsertProxy(i, proxies[i]);
+	}
+
+	// Group entries by cell, keeping proxies in index order within a cell
+	sort(mEntries.begin(), mEntries.end());
+
+	// Every pair of proxies within a cell is a candidate
+	vector<CellEntry>::const_iterator first = mEntries.begin();
+	while (first != mEntries.end()) {
+		vector<CellEntry>::const_iterator last = first;
+		while (last != mEntries.end() && last->first == first->first) ++last;
+		for (vector<CellEntry>::const_iterator a = first; a != last; ++a) {
+			for (vector<CellEntry>::const_iterator b = a + 1; b != last; ++b) {
+				pairs.push_back(CollisionPair(a->second, b->second));
+			}
+		}
+		first = last;
+	}
+
+	// Proxies sharing several cells produce duplicate pairs
+	sort(pairs.begin(), pairs.end());
+	pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Add an entry for each cell overlapped by the proxy, wrapping around the world's edges. */
+void SpatialHash::InsertProxy(uint index, const BroadphaseProxy& proxy)
+{
+	int x1 = (int)floor((proxy.x - proxy.radius - mOriginX) / mCellWidth);
+	int x2 = (int)floor((proxy.x + proxy.radius - mOriginX) / mCellWidth);
+	int y1 = (int)floor((proxy.y - proxy.radius - mOriginY) / mCellHeight);
+	int y2 = (int)floor((proxy.y + proxy.radius - mOriginY) / mCellHeight);
+
+	// A proxy wider than the world covers every cell exactly once
+	if (x2 - x1 + 1 >= mCellsX) { x1 = 0; x2 = mCellsX - 1; }
+	if (y2 - y1 + 1 >= mCellsY) { y1 = 0; y2 = mCellsY - 1; }
+
+	for (int y = y1; y <= y2; y++) {
+		int row = WrapCell(y, mCellsY) * mCellsX;
+		for (int x = x1; x <= x2; x++) {
+			mEntries.push_back(CellEntry(row + WrapCell(x, mCellsX), index));
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef __SPATIALHASH_H__
+#define __SPATIALHASH_H__
+
+#include "GameUtil.h"
+#include "IBroadphase.h"
+
+class SpatialHash : public IBroadphase
+{
+public:
+	SpatialHash(void);
+	virtual ~SpatialHash(void);
+
+	void FindPairs(const BroadphaseProxyList& proxies, float width, float height, CollisionPairList& pairs);
+
+	// A cell size of zero sizes cells to the largest proxy each frame
+	void SetCellSize(float s) { mCellSize = s; }
+	float GetCellSize() { return mCellSize; }
+
+protected:
+	void InsertProxy(uint index, const BroadphaseProxy& proxy);
+
+	// Cell/proxy pairs, sorted by cell before pairs are generated
+	typedef pair< uint, uint > CellEntry;
+	vector< CellEntry > mEntries;
+
+	float mCellSize;
+
+	// Dimensions of the grid used for the current frame
+	int mCellsX;
+	int mCellsY;
+	float mCellWidth;
+	float mCellHeight;
+	float mOriginX;
+	float mOriginY;
+};
+
+#endif
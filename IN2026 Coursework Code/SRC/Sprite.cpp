@@ -4,6 +4,9 @@
 #include "Texture.h"
 #include "Animation.h"
 #include "Sprite.h"
+#include "SpriteBatch.h"
+#include "RenderState.h"
+#include "StateStream.h"
 
 // PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
 
@@ -63,6 +66,28 @@ void Sprite::Update(int t)
 	}
 }
 
+/** Go back to the first frame and start animating again, so the sprite can be reused. */
+void Sprite::Rewind()
+{
+	mCurrentFrame = 0;
+	mFrameMillis = 0;
+	mAnimating = true;
+}
+
+/** Get the distance from the sprite's centre to its furthest corner. */
+GLfloat Sprite::GetRadius()
+{
+	float x = (float)max(mOffsetX, mWidth - mOffsetX);
+	float y = (float)max(mOffsetY, mHeight - mOffsetY);
+	return sqrt(x * x + y * y);
+}
+
+/** Get the texture holding the sprite's frames. */
+uint Sprite::GetTextureID()
+{
+	return mAnimation->GetTextureID();
+}
+
 /*
 void Sprite::Render()
 {
@@ -94,17 +119,49 @@ void Sprite::Render()
 	float y1 = (float)(-mOffsetY);
 	float x2 = (float)(mWidth - mOffsetX);
 	float y2 = (float)(mHeight - mOffsetY);
+	const float* rect = mAnimation->GetFrameRect(mCurrentFrame);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_BLEND);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, mAnimation->GetFrameTextureID(mCurrentFrame));
+	RenderState::GetInstance().SetSpriteState(mAnimation->GetTextureID());
 	glBegin(GL_QUADS);
-		glTexCoord2f(0.0f, 0.0f); glVertex3f(x1, y1, 0.0f);
-		glTexCoord2f(1.0f, 0.0f); glVertex3f(x2, y1, 0.0f);
-		glTexCoord2f(1.0f, 1.0f); glVertex3f(x2, y2, 0.0f);
-		glTexCoord2f(0.0f, 1.0f); glVertex3f(x1, y2, 0.0f);
+		glTexCoord2f(rect[0], rect[1]); glVertex3f(x1, y1, 0.0f);
+		glTexCoord2f(rect[2], rect[1]); glVertex3f(x2, y1, 0.0f);
+		glTexCoord2f(rect[2], rect[3]); glVertex3f(x2, y2, 0.0f);
+		glTexCoord2f(rect[0], rect[3]); glVertex3f(x1, y2, 0.0f);
 	glEnd();
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+}
+
+/** Add the current frame to a batch, transformed as PreRender would transform it. */
+void Sprite::RenderToBatch(SpriteBatch& batch, const GLVector3f& position, GLfloat angle, GLfloat scale)
+{
+	const float* rect = mAnimation->GetFrameRect(mCurrentFrame);
+	batch.AddQuad(mAnimation->GetTextureID(), position, angle, scale,
+		(float)(-mOffsetX), (float)(-mOffsetY), (float)(mWidth - mOffsetX), (float)(mHeight - mOffsetY),
+		rect[0], rect[1], rect[2], rect[3]);
+}
+
+/** Save how far through its animation the sprite is. */
+void Sprite::SaveState(StateWriter& writer)
+{
+	writer.Write(mCurrentFrame);
+	writer.Write(mFrameMillis);
+	writer.Write(mAnimating);
+}
+
+/** Restore the state saved by SaveState. */
+void Sprite::RestoreState(StateReader& reader)
+{
+	reader.Read(mCurrentFrame);
+	reader.Read(mFrameMillis);
+	reader.Read(mAnimating);
+	if (mCurrentFrame < 0 || mCurrentFrame >= mFrames) mCurrentFrame = 0;
+}
+
+/** Read past a saved sprite state without restoring it. */
+void Sprite::SkipState(StateReader& reader)
+{
+	int frame, frame_millis;
+	bool animating;
+	reader.Read(frame);
+	reader.Read(frame_millis);
+	reader.Read(animating);
 }
\ No newline at end of file
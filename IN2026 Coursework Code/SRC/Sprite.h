@@ -5,6 +5,9 @@
 
 // class Texture;
 class Animation;
+class SpriteBatch;
+class StateWriter;
+class StateReader;
 
 class Sprite
 {
@@ -15,6 +18,12 @@ public:
 
 	virtual void Update(int t);
 	virtual void Render(void);
+	void RenderToBatch(SpriteBatch& batch, const GLVector3f& position, GLfloat angle, GLfloat scale);
+
+	void Rewind(void);
+
+	GLfloat GetRadius();
+	uint GetTextureID();
 
 	void SetCurrentFrame(int f) { mCurrentFrame = f % mFrames; }
 	int GetCurrentFrame() { return mCurrentFrame; }
@@ -24,6 +33,10 @@ public:
 
 	bool IsAnimating() { return mAnimating; }
 
+	void SaveState(StateWriter& writer);
+	void RestoreState(StateReader& reader);
+	static void SkipState(StateReader& reader);
+
 private:
 	int mWidth;
 	int mHeight;
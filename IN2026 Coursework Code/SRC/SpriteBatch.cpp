@@ -0,0 +1,167 @@
+#include "GameUtil.h"
+#include "SpriteBatch.h"
+#include "Shape.h"
+#include "RenderState.h"
+#include <algorithm>
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+SpriteBatch::SpriteBatch(void)
+	: mNumQuads(0),
+	  mNumShapes(0),
+	  mNumDrawCalls(0)
+{
+}
+
+/** Destructor. */
+SpriteBatch::~SpriteBatch(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Start collecting quads for a frame. */
+void SpriteBatch::Begin()
+{
+	mVertices.clear();
+	mTextureIDs.clear();
+	mLineVertices.clear();
+	mShapes.clear();
+}
+
+/** Add a quad spanning (x1,y1) to (x2,y2) before being scaled, rotated by angle
+	degrees and moved to position, as PreRender would transform it, textured with
+	the rectangle (u1,v1) to (u2,v2) of the texture. */
+void SpriteBatch::AddQuad(uint texture_id, const GLVector3f& position, GLfloat angle, GLfloat scale,
+	GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2, GLfloat u1, GLfloat v1, GLfloat u2, GLfloat v2)
+{
+	GLfloat c = (GLfloat)cos(DEG2RAD * angle) * scale;
+	GLfloat s = (GLfloat)sin(DEG2RAD * angle) * scale;
+	GLfloat xs[] = { x1, x2, x2, x1 };
+	GLfloat ys[] = { y1, y1, y2, y2 };
+	GLfloat us[] = { u1, u2, u2, u1 };
+	GLfloat vs[] = { v1, v1, v2, v2 };
+	for (int i = 0; i < 4; i++) {
+		Vertex vertex;
+		vertex.x = position.x + c * xs[i] - s * ys[i];
+		vertex.y = position.y + s * xs[i] + c * ys[i];
+		vertex.z = position.z;
+		vertex.u = us[i];
+		vertex.v = vs[i];
+		mVertices.push_back(vertex);
+	}
+	mTextureIDs.push_back(texture_id);
+}
+
+/** Add the lines of a shape, transformed as PreRender would transform it. */
+void SpriteBatch::AddShape(Shape* shape, const GLVector3f& position, GLfloat angle, GLfloat scale)
+{
+	const GLVector2fVector& points = shape->GetPoints();
+	uint n = (uint)points.size();
+	if (n < 2) return;
+	GLfloat c = (GLfloat)cos(DEG2RAD * angle) * scale;
+	GLfloat s = (GLfloat)sin(DEG2RAD * angle) * scale;
+
+	// Draw strips and loops as separate segments so many shapes share one draw call
+	ShapeInstance instance;
+	instance.shape = shape;
+	instance.begin = (uint)mLineVertices.size();
+	uint num_segments = shape->IsLoop() ? n : n - 1;
+	for (uint i = 0; i < num_segments; i++) {
+		const GLVector2f& p1 = points[i];
+		const GLVector2f& p2 = points[(i + 1) % n];
+		mLineVertices.push_back(GLVector3f(position.x + c * p1.x - s * p1.y, position.y + s * p1.x + c * p1.y, position.z));
+		mLineVertices.push_back(GLVector3f(position.x + c * p2.x - s * p2.y, position.y + s * p2.x + c * p2.y, position.z));
+	}
+	instance.end = (uint)mLineVertices.size();
+	mShapes.push_back(instance);
+}
+
+/** Draw every shape and quad added since Begin with one draw call per shape and
+	per texture. Quads with the same texture keep the order they were added in. */
+void SpriteBatch::End()
+{
+	mNumQuads = (uint)mTextureIDs.size();
+	mNumShapes = (uint)mShapes.size();
+	mNumDrawCalls = 0;
+	if (mNumShapes > 0) DrawShapes();
+	if (mNumQuads == 0) return;
+
+	// Sort by texture, then by the order quads were added
+	mOrder.resize(mNumQuads);
+	for (uint i = 0; i < mNumQuads; i++) mOrder[i] = make_pair(mTextureIDs[i], i);
+	sort(mOrder.begin(), mOrder.end());
+	mSortedVertices.resize(mVertices.size());
+	for (uint i = 0; i < mNumQuads; i++) {
+		const Vertex* quad = &mVertices[mOrder[i].second * 4];
+		copy(quad, quad + 4, &mSortedVertices[i * 4]);
+	}
+
+	// Set up state once for the whole batch rather than once per sprite
+	RenderState& state = RenderState::GetInstance();
+	state.SetSpriteState(mOrder[0].first);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &mSortedVertices[0].x);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &mSortedVertices[0].u);
+
+	// Draw each run of quads sharing a texture
+	uint begin = 0;
+	while (begin < mNumQuads) {
+		uint texture_id = mOrder[begin].first;
+		uint end = begin + 1;
+		while (end < mNumQuads && mOrder[end].first == texture_id) end++;
+		state.BindTexture(texture_id);
+		glDrawArrays(GL_QUADS, begin * 4, (end - begin) * 4);
+		mNumDrawCalls++;
+		begin = end;
+	}
+
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Draw the lines of every shape added, one draw call for each different shape. */
+void SpriteBatch::DrawShapes()
+{
+	// Group instances of the same shape, keeping the order they were added in
+	stable_sort(mShapes.begin(), mShapes.end());
+	mSortedLineVertices.resize(mLineVertices.size());
+	uint next = 0;
+	for (uint i = 0; i < mNumShapes; i++) {
+		const ShapeInstance& instance = mShapes[i];
+		copy(mLineVertices.begin() + instance.begin, mLineVertices.begin() + instance.end, mSortedLineVertices.begin() + next);
+		next += instance.end - instance.begin;
+	}
+
+	// Disable lighting for solid colour lines, as Shape does
+	RenderState& state = RenderState::GetInstance();
+	state.SetLighting(false);
+	state.SetTexturing(false);
+	state.SetBlending(false);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, sizeof(GLVector3f), &mSortedLineVertices[0]);
+
+	uint begin = 0;
+	uint first = 0;
+	while (begin < mNumShapes) {
+		Shape* shape = mShapes[begin].shape;
+		uint count = 0;
+		uint end = begin;
+		while (end < mNumShapes && mShapes[end].shape == shape) {
+			count += mShapes[end].end - mShapes[end].begin;
+			end++;
+		}
+		const GLVector3f& rgb = shape->GetRGBColour();
+		state.SetColour(rgb.x, rgb.y, rgb.z);
+		glDrawArrays(GL_LINES, first, count);
+		mNumDrawCalls++;
+		first += count;
+		begin = end;
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
@@ -0,0 +1,63 @@
+#ifndef __SPRITEBATCH_H__
+#define __SPRITEBATCH_H__
+
+#include "GameUtil.h"
+#include <vector>
+
+class Shape;
+
+class SpriteBatch
+{
+public:
+	SpriteBatch(void);
+	~SpriteBatch(void);
+
+	void Begin();
+	void AddQuad(uint texture_id, const GLVector3f& position, GLfloat angle, GLfloat scale,
+		GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2,
+		GLfloat u1 = 0.0f, GLfloat v1 = 0.0f, GLfloat u2 = 1.0f, GLfloat v2 = 1.0f);
+	void AddShape(Shape* shape, const GLVector3f& position, GLfloat angle, GLfloat scale);
+	void End();
+
+	uint GetNumQuads() const { return mNumQuads; }
+	uint GetNumShapes() const { return mNumShapes; }
+	uint GetNumDrawCalls() const { return mNumDrawCalls; }
+
+protected:
+	void DrawShapes();
+
+	// Vertices are interleaved so one array serves for positions and texture coordinates
+	struct Vertex
+	{
+		GLfloat x, y, z;
+		GLfloat u, v;
+	};
+
+	// Quads in the order they were added, four vertices each, and their textures
+	vector< Vertex > mVertices;
+	vector< uint > mTextureIDs;
+	// Texture and index of each quad, sorted so quads sharing a texture are together
+	vector< pair< uint, uint > > mOrder;
+	// Vertices of the quads in sorted order, ready to submit
+	vector< Vertex > mSortedVertices;
+
+	// Each shape added, with the run of line vertices it was transformed into
+	struct ShapeInstance
+	{
+		Shape* shape;
+		uint begin;
+		uint end;
+		bool operator<(const ShapeInstance& other) const { return shape < other.shape; }
+	};
+	// Shapes as line segments in the order they were added, and sorted by shape
+	vector< GLVector3f > mLineVertices;
+	vector< ShapeInstance > mShapes;
+	vector< GLVector3f > mSortedLineVertices;
+
+	// Quads, shapes and draw calls submitted by the last End
+	uint mNumQuads;
+	uint mNumShapes;
+	uint mNumDrawCalls;
+};
+
+#endif
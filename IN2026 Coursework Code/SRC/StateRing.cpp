@@ -0,0 +1,218 @@
+#include <string.h>
+#include "GameUtil.h"
+#include "StateRing.h"
+
+// Changed bytes are grouped into one run until this many unchanged bytes follow
+static const size_t MIN_UNCHANGED_RUN = 2;
+
+/** Append a number to a buffer, seven bits to a byte, low bits first. */
+static inline void WriteVarint(vector<uchar>& buffer, size_t n)
+{
+	while (n >= 0x80) {
+		buffer.push_back((uchar)(n | 0x80));
+		n >>= 7;
+	}
+	buffer.push_back((uchar)n);
+}
+
+/** Read a number written by WriteVarint, advancing p. */
+static inline size_t ReadVarint(const uchar*& p, const uchar* end)
+{
+	size_t n = 0;
+	for (int shift = 0; p != end; shift += 7) {
+		uchar b = *p++;
+		n |= (size_t)(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) break;
+	}
+	return n;
+}
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Construct a ring holding at least the newest capacity states, with a whole state
+	kept every keyframe_interval states and the rest kept as differences from it. */
+StateRing::StateRing(uint capacity, uint keyframe_interval)
+	: mCapacity(capacity),
+	  mKeyframeInterval(max(keyframe_interval, 1u)),
+	  mSinceKeyframe(0),
+	  mNumBytes(0),
+	  mNumStateBytes(0)
+{
+}
+
+/** Destructor. */
+StateRing::~StateRing(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Set the number of the newest states that are always held, dropping older ones
+	no longer needed for them. */
+void StateRing::SetCapacity(uint capacity)
+{
+	mCapacity = capacity;
+	DropOldest();
+}
+
+/** Add a state saved at a time, dropping the oldest states if the ring is full.
+	States are compared with the last keyframe, so only the bytes that differ from
+	it are kept. */
+void StateRing::Push(const vector<uchar>& state, uint time)
+{
+	if (mCapacity == 0) return;
+
+	bool keyframe = mEntries.empty() || mSinceKeyframe + 1 >= mKeyframeInterval;
+	mEntries.push_back(Entry());
+	Entry& entry = mEntries.back();
+	entry.keyframe = keyframe;
+	entry.time = time;
+	entry.state_size = (uint)state.size();
+	if (!mSpareBuffers.empty()) {
+		entry.data.swap(mSpareBuffers.back());
+		mSpareBuffers.pop_back();
+	}
+	if (keyframe) {
+		entry.data.assign(state.begin(), state.end());
+		mSinceKeyframe = 0;
+	} else {
+		// The newest entry is the one being filled, so search from the one before it
+		deque<Entry>::reverse_iterator previous = mEntries.rbegin() + 1;
+		while (!previous->keyframe) ++previous;
+		Encode(previous->data, state, entry.data);
+		mSinceKeyframe++;
+	}
+	mNumBytes += entry.data.size();
+	mNumStateBytes += entry.state_size;
+
+	DropOldest();
+}
+
+/** Rebuild the state saved steps_back states before the newest, returning false
+	if the ring does not go back that far. */
+bool StateRing::Get(uint steps_back, vector<uchar>& state)
+{
+	if (steps_back >= mEntries.size()) return false;
+	size_t i = mEntries.size() - 1 - steps_back;
+	const Entry& entry = mEntries[i];
+	if (entry.keyframe) {
+		state.assign(entry.data.begin(), entry.data.end());
+		return true;
+	}
+	while (!mEntries[i].keyframe) i--;
+	state.resize(entry.state_size);
+	Decode(mEntries[i].data, entry.data.empty() ? NULL : &entry.data[0], entry.data.size(), state);
+	return true;
+}
+
+/** Find how many states back the newest state saved at or before a time is, or
+	-1 if every state was saved after it. */
+int StateRing::FindStepsBack(uint time)
+{
+	for (size_t steps_back = 0; steps_back < mEntries.size(); steps_back++) {
+		if (mEntries[mEntries.size() - 1 - steps_back].time <= time) return (int)steps_back;
+	}
+	return -1;
+}
+
+/** Drop the n newest states, as after going back to an earlier state they are
+	of a future that will not now happen. */
+void StateRing::DropNewest(uint n)
+{
+	for (uint i = 0; i < n && !mEntries.empty(); i++) {
+		Entry& entry = mEntries.back();
+		mNumBytes -= entry.data.size();
+		mNumStateBytes -= entry.state_size;
+		mSpareBuffers.push_back(vector<uchar>());
+		mSpareBuffers.back().swap(entry.data);
+		mEntries.pop_back();
+	}
+	// Later states carry on from the last keyframe left
+	mSinceKeyframe = 0;
+	for (deque<Entry>::reverse_iterator it = mEntries.rbegin(); it != mEntries.rend() && !it->keyframe; ++it) {
+		mSinceKeyframe++;
+	}
+}
+
+/** Drop every state. */
+void StateRing::Clear(void)
+{
+	DropNewest((uint)mEntries.size());
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Encode the bytes of a state that differ from a keyframe, as pairs of the
+	number of unchanged bytes to skip and a run of changed bytes XORed with the
+	keyframe. Bytes past the end of the keyframe are compared with zero. */
+void StateRing::Encode(const vector<uchar>& keyframe, const vector<uchar>& state, vector<uchar>& delta)
+{
+	delta.clear();
+	size_t n = state.size();
+	size_t k = keyframe.size();
+	size_t i = 0;
+	while (i < n) {
+		// Skip unchanged bytes
+		size_t start = i;
+		while (i < n && state[i] == (i < k ? keyframe[i] : 0)) i++;
+		if (i == n) break;
+		WriteVarint(delta, i - start);
+		// Take changed bytes up to the next long enough run of unchanged ones
+		size_t run_start = i;
+		size_t unchanged = 0;
+		size_t run_end = i;
+		while (i < n && unchanged < MIN_UNCHANGED_RUN) {
+			if (state[i] == (i < k ? keyframe[i] : 0)) unchanged++;
+			else { unchanged = 0; run_end = i + 1; }
+			i++;
+		}
+		i = run_end;
+		WriteVarint(delta, run_end - run_start);
+		for (size_t j = run_start; j < run_end; j++) delta.push_back(state[j] ^ (j < k ? keyframe[j] : 0));
+	}
+}
+
+/** Rebuild a state, already sized, from a keyframe and the delta Encode made. */
+void StateRing::Decode(const vector<uchar>& keyframe, const uchar* delta, size_t delta_size, vector<uchar>& state)
+{
+	size_t n = state.size();
+	size_t k = min(keyframe.size(), n);
+	if (k > 0) memcpy(&state[0], &keyframe[0], k);
+	if (n > k) memset(&state[k], 0, n - k);
+
+	const uchar* p = delta;
+	const uchar* end = delta + delta_size;
+	size_t i = 0;
+	while (p != end) {
+		i += ReadVarint(p, end);
+		size_t length = ReadVarint(p, end);
+		for (size_t j = 0; j < length && p != end && i < n; j++) state[i++] ^= *p++;
+	}
+}
+
+/** Drop the oldest groups of a keyframe and the states kept as differences from
+	it, for as long as at least capacity states would be left. Up to one group less
+	one state more than the capacity is therefore held, so the newest capacity
+	states can always be rebuilt. */
+void StateRing::DropOldest(void)
+{
+	while (!mEntries.empty()) {
+		size_t group_size = 1;
+		while (group_size < mEntries.size() && !mEntries[group_size].keyframe) group_size++;
+		if (mEntries.size() - group_size < mCapacity) break;
+		PopOldest();
+	}
+}
+
+/** Drop the oldest state, and the states kept as differences from it if it was a keyframe. */
+void StateRing::PopOldest(void)
+{
+	do {
+		Entry& entry = mEntries.front();
+		mNumBytes -= entry.data.size();
+		mNumStateBytes -= entry.state_size;
+		mSpareBuffers.push_back(vector<uchar>());
+		mSpareBuffers.back().swap(entry.data);
+		mEntries.pop_front();
+	} while (!mEntries.empty() && !mEntries.front().keyframe);
+}
@@ -0,0 +1,61 @@
+#ifndef __STATERING_H__
+#define __STATERING_H__
+
+#include "GameUtil.h"
+#include <deque>
+#include <vector>
+
+class StateRing
+{
+public:
+	StateRing(uint capacity = 0, uint keyframe_interval = 60);
+	~StateRing(void);
+
+	void SetCapacity(uint capacity);
+	uint GetCapacity() { return mCapacity; }
+	void SetKeyframeInterval(uint n) { mKeyframeInterval = max(n, 1u); }
+	uint GetKeyframeInterval() { return mKeyframeInterval; }
+
+	void Push(const vector<uchar>& state, uint time);
+	bool Get(uint steps_back, vector<uchar>& state);
+	int FindStepsBack(uint time);
+	void DropNewest(uint n);
+	void Clear(void);
+
+	uint GetSize() { return (uint)mEntries.size(); }
+	uint GetTime(uint steps_back) { return mEntries[mEntries.size() - 1 - steps_back].time; }
+	size_t GetNumBytes() { return mNumBytes; }
+	size_t GetNumStateBytes() { return mNumStateBytes; }
+
+protected:
+	// A keyframe holds a whole state. Every other entry holds the difference
+	// between its state and the keyframe before it, as runs of unchanged bytes
+	// and of changed bytes XORed with the keyframe's
+	struct Entry
+	{
+		bool keyframe;
+		// Time the state was saved at, to find how far back to go
+		uint time;
+		uint state_size;
+		vector< uchar > data;
+	};
+
+	void Encode(const vector<uchar>& keyframe, const vector<uchar>& state, vector<uchar>& delta);
+	void Decode(const vector<uchar>& keyframe, const uchar* delta, size_t delta_size, vector<uchar>& state);
+	void DropOldest(void);
+	void PopOldest(void);
+
+	deque< Entry > mEntries;
+	uint mCapacity;
+	uint mKeyframeInterval;
+	// Entries pushed since the last keyframe
+	uint mSinceKeyframe;
+	// Buffers of dropped entries, kept to be reused by later ones
+	vector< vector< uchar > > mSpareBuffers;
+
+	// Bytes held in entries, and bytes the whole states would have taken
+	size_t mNumBytes;
+	size_t mNumStateBytes;
+};
+
+#endif
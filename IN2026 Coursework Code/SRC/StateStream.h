@@ -0,0 +1,94 @@
+#ifndef __STATESTREAM_H__
+#define __STATESTREAM_H__
+
+#include <string.h>
+#include "GameUtil.h"
+#include <vector>
+
+// Saved states start with a magic number and a version, followed by the packed
+// little-endian fields of the session, its world and each object in turn
+const uint SAVED_STATE_MAGIC = 0x54415453; // "STAT"
+const uint SAVED_STATE_VERSION = 1;
+
+// Fields are copied through an unsigned word of the same size, so they can be
+// written low byte first whatever the byte order of the machine
+template <size_t size> struct StateWord {};
+template <> struct StateWord<1> { typedef uchar Type; };
+template <> struct StateWord<2> { typedef unsigned short Type; };
+template <> struct StateWord<4> { typedef uint Type; };
+template <> struct StateWord<8> { typedef unsigned long long Type; };
+
+/** Appends packed fields to a byte buffer, which keeps its capacity between
+	states so that saving every tick does not allocate. */
+class StateWriter
+{
+public:
+	StateWriter(vector<uchar>& buffer) : mBuffer(buffer) { mBuffer.clear(); }
+
+	template <class T>
+	void Write(const T& value)
+	{
+		typename StateWord<sizeof(T)>::Type word;
+		memcpy(&word, &value, sizeof(T));
+		size_t size = mBuffer.size();
+		mBuffer.resize(size + sizeof(T));
+		for (size_t i = 0; i < sizeof(T); i++) mBuffer[size + i] = (uchar)(word >> (8 * i));
+	}
+
+	// Vectors are not trivially copyable, so their components are written in turn
+	void Write(const GLVector3f& value)
+	{
+		Write(value.x);
+		Write(value.y);
+		Write(value.z);
+	}
+
+	uint GetSize() { return (uint)mBuffer.size(); }
+
+private:
+	vector<uchar>& mBuffer;
+};
+
+/** Reads packed fields back out of a byte buffer. Reading past the end reads
+	zeros and marks the reader as failed, so callers can check once at the end. */
+class StateReader
+{
+public:
+	StateReader(const uchar* data, uint size) : mData(data), mSize(size), mPosition(0), mFailed(false) {}
+	StateReader(const vector<uchar>& buffer)
+		: mData(buffer.empty() ? NULL : &buffer[0]), mSize((uint)buffer.size()), mPosition(0), mFailed(false) {}
+
+	template <class T>
+	bool Read(T& value)
+	{
+		if (mFailed || mSize - mPosition < sizeof(T)) {
+			memset(&value, 0, sizeof(T));
+			mFailed = true;
+			return false;
+		}
+		typedef typename StateWord<sizeof(T)>::Type Word;
+		Word word = 0;
+		for (size_t i = 0; i < sizeof(T); i++) word |= (Word)((Word)mData[mPosition + i] << (8 * i));
+		memcpy(&value, &word, sizeof(T));
+		mPosition += sizeof(T);
+		return true;
+	}
+
+	bool Read(GLVector3f& value)
+	{
+		Read(value.x);
+		Read(value.y);
+		return Read(value.z);
+	}
+
+	bool HasFailed() { return mFailed; }
+	bool IsAtEnd() { return mPosition == mSize; }
+
+private:
+	const uchar* mData;
+	uint mSize;
+	uint mPosition;
+	bool mFailed;
+};
+
+#endif
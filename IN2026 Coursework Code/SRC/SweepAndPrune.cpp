@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "GameUtil.h"
+#include "SweepAndPrune.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Default constructor. */
+SweepAndPrune::SweepAndPrune(void)
+{
+}
+
+/** Destructor. */
+SweepAndPrune::~SweepAndPrune(void)
+{
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Find all pairs of proxies whose bounds overlap along both axes. Intervals
+	are not wrapped, as the narrowphase does not test across the world's edges. */
+void SweepAndPrune::FindPairs(const BroadphaseProxyList& proxies, float width, float height, CollisionPairList& pairs)
+{
+	pairs.clear();
+	mActive.clear();
+
+	UpdateEndpoints(proxies);
+	SortEndpoints();
+
+	// Sweep along the x axis, testing each opening interval against those already open
+	for (vector<Endpoint>::const_iterator it = mEndpoints.begin(); it != mEndpoints.end(); ++it) {
+		if (it->upper) {
+			vector<uint>::iterator active = find(mActive.begin(), mActive.end(), it->proxy);
+			*active = mActive.back();
+			mActive.pop_back();
+			continue;
+		}
+		const BroadphaseProxy& p1 = proxies[it->proxy];
+		for (vector<uint>::const_iterator active = mActive.begin(); active != mActive.end(); ++active) {
+			const BroadphaseProxy& p2 = proxies[*active];
+			if (fabs(p1.y - p2.y) <= p1.radius + p2.radius) {
+				pairs.push_back(CollisionPair(min(it->proxy, *active), max(it->proxy, *active)));
+			}
+		}
+		mActive.push_back(it->proxy);
+	}
+
+	// Keep the order of pairs independent of the order of the sweep
+	sort(pairs.begin(), pairs.end());
+}
+
+/** Forget all endpoints, so the next frame sorts from scratch. */
+void SweepAndPrune::Clear()
+{
+	mEndpoints.clear();
+	mActive.clear();
+	mProxyIndices.clear();
+	mHasEndpoints.clear();
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Refresh endpoints from this frame's proxies, dropping removed objects and appending new ones. */
+void SweepAndPrune::UpdateEndpoints(const BroadphaseProxyList& proxies)
+{
+	mProxyIndices.clear();
+	for (uint i = 0; i < proxies.size(); i++) {
+		mProxyIndices.push_back(ProxyIndex(proxies[i].object, i));
+	}
+	sort(mProxyIndices.begin(), mProxyIndices.end());
+	mHasEndpoints.assign(proxies.size(), false);
+
+	// Update endpoints in place, compacting out objects that have left
+	uint n = 0;
+	for (uint i = 0; i < mEndpoints.size(); i++) {
+		Endpoint e = mEndpoints[i];
+		vector<ProxyIndex>::const_iterator it =
+			lower_bound(mProxyIndices.begin(), mProxyIndices.end(), ProxyIndex(e.object, 0));
+		if (it == mProxyIndices.end() || it->first != e.object) continue;
+		const BroadphaseProxy& proxy = proxies[it->second];
+		e.proxy = it->second;
+		e.value = e.upper ? proxy.x + proxy.radius : proxy.x - proxy.radius;
+		mHasEndpoints[e.proxy] = true;
+		mEndpoints[n++] = e;
+	}
+	mEndpoints.resize(n);
+
+	// Append endpoints for objects seen for the first time
+	for (uint i = 0; i < proxies.size(); i++) {
+		if (mHasEndpoints[i]) continue;
+		Endpoint lower = { proxies[i].object, i, proxies[i].x - proxies[i].radius, false };
+		Endpoint upper = { proxies[i].object, i, proxies[i].x + proxies[i].radius, true };
+		mEndpoints.push_back(lower);
+		mEndpoints.push_back(upper);
+	}
+}
+
+/** Insertion sort endpoints, which is close to linear as objects move little between frames.
+	Lower endpoints sort before upper endpoints of equal value so touching bounds overlap. */
+void SweepAndPrune::SortEndpoints()
+{
+	for (uint i = 1; i < mEndpoints.size(); i++) {
+		Endpoint e = mEndpoints[i];
+		uint j = i;
+		while (j > 0) {
+			const Endpoint& prev = mEndpoints[j - 1];
+			if (prev.value < e.value || (prev.value == e.value && (!prev.upper || e.upper))) break;
+			mEndpoints[j] = prev;
+			j--;
+		}
+		mEndpoints[j] = e;
+	}
+}
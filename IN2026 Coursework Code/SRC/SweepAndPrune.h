@@ -0,0 +1,41 @@
+#ifndef __SWEEPANDPRUNE_H__
+#define __SWEEPANDPRUNE_H__
+
+#include "GameUtil.h"
+#include "IBroadphase.h"
+
+class SweepAndPrune : public IBroadphase
+{
+public:
+	SweepAndPrune(void);
+	virtual ~SweepAndPrune(void);
+
+	void FindPairs(const BroadphaseProxyList& proxies, float width, float height, CollisionPairList& pairs);
+
+	void Clear();
+
+protected:
+	// The lower or upper end of a proxy's interval along the x axis
+	struct Endpoint
+	{
+		GameObject* object;
+		uint proxy;
+		float value;
+		bool upper;
+	};
+
+	void UpdateEndpoints(const BroadphaseProxyList& proxies);
+	void SortEndpoints();
+
+	// Endpoints kept sorted from one frame to the next
+	vector< Endpoint > mEndpoints;
+	// Proxies whose intervals are open during the sweep
+	vector< uint > mActive;
+	// Lookup from object to proxy index for the current frame, sorted by object
+	typedef pair< GameObject*, uint > ProxyIndex;
+	vector< ProxyIndex > mProxyIndices;
+	// Flags proxies that already have endpoints in the list
+	vector< bool > mHasEndpoints;
+};
+
+#endif
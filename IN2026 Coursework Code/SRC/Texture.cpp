@@ -1,6 +1,7 @@
 #include "GameUtil.h"
 #include "Image.h"
 #include "Texture.h"
+#include "RenderState.h"
 
 using namespace std;
 
@@ -16,7 +17,7 @@ Texture::Texture(Image* image)
 	mImageHeight = image->GetHeight();
 
 	// Bind a texture to an image using id
-	glBindTexture(GL_TEXTURE_2D, mTextureID);
+	RenderState::GetInstance().BindTexture(mTextureID);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mImageWidth, mImageHeight, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, image->GetPixelData());
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
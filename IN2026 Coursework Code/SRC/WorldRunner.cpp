@@ -0,0 +1,107 @@
+#include "GameUtil.h"
+#include "GameWorld.h"
+#include "AgentSession.h"
+#include "WorldRunner.h"
+
+// PUBLIC INSTANCE CONSTRUCTORS ///////////////////////////////////////////////
+
+/** Construct a runner of num_worlds independent worlds, each in a session made by
+	factory, stepped across num_threads threads. With num_threads of 0 there is a
+	thread for each core. */
+WorldRunner::WorldRunner(uint num_worlds, const SessionFactory& factory, uint num_threads)
+	: mJobSystem(num_threads),
+	  mObservationSize(0),
+	  mFrameTime(1000 / 60),
+	  mFramesPerStep(1),
+	  mNeedsReset(num_worlds, 1),
+	  mNumFramesRun(num_worlds, 0),
+	  mNumEpisodesFinished(num_worlds, 0)
+{
+	for (uint i = 0; i < num_worlds; i++) mSessions.push_back(factory(i));
+	if (!mSessions.empty()) mObservationSize = mSessions[0]->GetObservationSize();
+}
+
+/** Destructor. Deletes the sessions. */
+WorldRunner::~WorldRunner(void)
+{
+	for (vector<AgentSession*>::iterator it = mSessions.begin(); it != mSessions.end(); ++it) delete *it;
+}
+
+// PUBLIC INSTANCE METHODS ////////////////////////////////////////////////////
+
+/** Start a new episode in every world and observe them. The episodes each world
+	plays are drawn from stream i of seed, so a run of the runner depends only on
+	seed and the actions taken, whatever the number of threads. */
+void WorldRunner::Reset(uint seed, vector<float>& observations)
+{
+	uint n = GetNumWorlds();
+	observations.resize(n * mObservationSize);
+	mSeedStreams.clear();
+	for (uint i = 0; i < n; i++) mSeedStreams.push_back(Random(seed, i));
+	mJobSystem.ParallelFor(n, 1, [this, &observations](uint begin, uint end, uint thread) {
+		for (uint i = begin; i < end; i++) {
+			mSessions[i]->Reset(mSeedStreams[i].Next());
+			mSessions[i]->Observe(&observations[i * mObservationSize]);
+			mNeedsReset[i] = 0;
+		}
+	});
+}
+
+/** Apply one action to each world, run every world for the frames of a step at
+	once across the threads, then observe them. A world whose episode ends stops
+	there and is marked done; its observation is of the end of the episode, and
+	it starts its next episode at the beginning of the following step. */
+void WorldRunner::Step(const vector<uint>& actions, vector<float>& observations, vector<uchar>& done)
+{
+	uint n = GetNumWorlds();
+	observations.resize(n * mObservationSize);
+	done.resize(n);
+	// Worlds that have never been reset play the episodes of seed 0
+	if (mSeedStreams.size() != n) {
+		mSeedStreams.clear();
+		for (uint i = 0; i < n; i++) mSeedStreams.push_back(Random(0, i));
+	}
+	mJobSystem.ParallelFor(n, 1, [this, &actions, &observations, &done](uint begin, uint end, uint thread) {
+		for (uint i = begin; i < end; i++) StepSession(i, actions[i], &observations[i * mObservationSize], done[i]);
+	});
+}
+
+/** Get the number of frames run across all worlds. */
+unsigned long long WorldRunner::GetNumFramesRun()
+{
+	unsigned long long total = 0;
+	for (size_t i = 0; i < mNumFramesRun.size(); i++) total += mNumFramesRun[i];
+	return total;
+}
+
+/** Get the number of episodes that have ended across all worlds. */
+uint WorldRunner::GetNumEpisodesFinished()
+{
+	uint total = 0;
+	for (size_t i = 0; i < mNumEpisodesFinished.size(); i++) total += mNumEpisodesFinished[i];
+	return total;
+}
+
+// PROTECTED INSTANCE METHODS /////////////////////////////////////////////////
+
+/** Step the session of world i. Only touches state belonging to world i, so
+	different worlds can be stepped on different threads at once. */
+void WorldRunner::StepSession(uint i, uint action, float* observation, uchar& done)
+{
+	AgentSession* session = mSessions[i];
+	if (mNeedsReset[i]) {
+		session->Reset(mSeedStreams[i].Next());
+		mNeedsReset[i] = 0;
+	}
+	session->Act(action);
+	for (uint f = 0; f < mFramesPerStep && !session->IsEpisodeOver(); f++) {
+		session->Tick(mFrameTime);
+		mNumFramesRun[i]++;
+	}
+	session->Observe(observation);
+	done = session->IsEpisodeOver() ? 1 : 0;
+	if (done) {
+		mNeedsReset[i] = 1;
+		mNumEpisodesFinished[i]++;
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef __WORLDRUNNER_H__
+#define __WORLDRUNNER_H__
+
+#include "GameUtil.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include <functional>
+#include <vector>
+
+class AgentSession;
+
+class WorldRunner
+{
+public:
+	// Creates the session of the world with the given index
+	typedef function< AgentSession* (uint index) > SessionFactory;
+
+	WorldRunner(uint num_worlds, const SessionFactory& factory, uint num_threads = 0);
+	~WorldRunner(void);
+
+	void Reset(uint seed, vector<float>& observations);
+	void Step(const vector<uint>& actions, vector<float>& observations, vector<uchar>& done);
+
+	void SetFrameTime(int dt) { mFrameTime = dt; }
+	int GetFrameTime() { return mFrameTime; }
+	void SetFramesPerStep(uint n) { mFramesPerStep = max(n, 1u); }
+	uint GetFramesPerStep() { return mFramesPerStep; }
+
+	uint GetNumWorlds() { return (uint)mSessions.size(); }
+	uint GetNumThreads() { return mJobSystem.GetNumThreads(); }
+	uint GetObservationSize() { return mObservationSize; }
+	unsigned long long GetNumFramesRun();
+	uint GetNumEpisodesFinished();
+
+	AgentSession* GetSession(uint i) { return mSessions[i]; }
+
+protected:
+	void StepSession(uint i, uint action, float* observation, uchar& done);
+
+	vector< AgentSession* > mSessions;
+	JobSystem mJobSystem;
+	uint mObservationSize;
+
+	// Milliseconds simulated by each frame, and frames run for each action
+	int mFrameTime;
+	uint mFramesPerStep;
+
+	// Seeds of the episodes of each world, drawn from a stream of their own so
+	// that which episodes a world plays does not depend on the other worlds
+	vector< Random > mSeedStreams;
+	// Whether each world's episode ended on the last step and must be reset
+	vector< uchar > mNeedsReset;
+	// Frames run and episodes finished by each world, kept apart so that
+	// worlds stepping on different threads never write the same counter
+	vector< unsigned long long > mNumFramesRun;
+	vector< uint > mNumEpisodesFinished;
+};
+
+#endif
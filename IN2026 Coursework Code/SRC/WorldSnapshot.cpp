@@ -0,0 +1,77 @@
+#include <string.h>
+#include "GameUtil.h"
+#include "StateStream.h"
+#include "WorldSnapshot.h"
+
+/** Copy a field into a buffer low byte first, returning the end of it. */
+template <class T>
+static inline uchar* Pack(uchar* buffer, const T& value)
+{
+	typename StateWord<sizeof(T)>::Type word;
+	memcpy(&word, &value, sizeof(T));
+	for (size_t i = 0; i < sizeof(T); i++) buffer[i] = (uchar)(word >> (8 * i));
+	return buffer + sizeof(T);
+}
+
+/** Copy a field out of a buffer low byte first, returning the end of it. */
+template <class T>
+static inline const uchar* Unpack(const uchar* buffer, T& value)
+{
+	typedef typename StateWord<sizeof(T)>::Type Word;
+	Word word = 0;
+	for (size_t i = 0; i < sizeof(T); i++) word |= (Word)((Word)buffer[i] << (8 * i));
+	memcpy(&value, &word, sizeof(T));
+	return buffer + sizeof(T);
+}
+
+/** Write a snapshot header as packed fields, returning the end of it. */
+uchar* WriteSnapshotHeader(uchar* buffer, const SnapshotHeader& header)
+{
+	buffer = Pack(buffer, header.magic);
+	buffer = Pack(buffer, header.version);
+	buffer = Pack(buffer, header.record_size);
+	buffer = Pack(buffer, header.tick);
+	buffer = Pack(buffer, header.num_objects);
+	return Pack(buffer, header.num_records);
+}
+
+/** Write a snapshot record as packed fields, returning the end of it. */
+uchar* WriteSnapshotRecord(uchar* buffer, const SnapshotRecord& record)
+{
+	buffer = Pack(buffer, record.type_id);
+	buffer = Pack(buffer, record.x);
+	buffer = Pack(buffer, record.y);
+	buffer = Pack(buffer, record.vx);
+	buffer = Pack(buffer, record.vy);
+	buffer = Pack(buffer, record.angle);
+	return Pack(buffer, record.radius);
+}
+
+/** Read the header of the snapshot in a buffer of size bytes, returning false if
+	it is not a snapshot this version can read or its records do not fit. */
+bool ReadSnapshotHeader(const uchar* buffer, uint size, SnapshotHeader& header)
+{
+	if (size < SNAPSHOT_HEADER_SIZE) return false;
+	buffer = Unpack(buffer, header.magic);
+	buffer = Unpack(buffer, header.version);
+	buffer = Unpack(buffer, header.record_size);
+	buffer = Unpack(buffer, header.tick);
+	buffer = Unpack(buffer, header.num_objects);
+	buffer = Unpack(buffer, header.num_records);
+	if (header.magic != WORLD_SNAPSHOT_MAGIC || header.version < 1) return false;
+	if (header.record_size < SNAPSHOT_RECORD_SIZE) return false;
+	return (unsigned long long)header.num_records * header.record_size <= size - SNAPSHOT_HEADER_SIZE;
+}
+
+/** Read record i of a snapshot whose header has been read. */
+void ReadSnapshotRecord(const uchar* buffer, const SnapshotHeader& header, uint i, SnapshotRecord& record)
+{
+	buffer += SNAPSHOT_HEADER_SIZE + i * header.record_size;
+	buffer = Unpack(buffer, record.type_id);
+	buffer = Unpack(buffer, record.x);
+	buffer = Unpack(buffer, record.y);
+	buffer = Unpack(buffer, record.vx);
+	buffer = Unpack(buffer, record.vy);
+	buffer = Unpack(buffer, record.angle);
+	Unpack(buffer, record.radius);
+}
@@ -0,0 +1,45 @@
+#ifndef __WORLDSNAPSHOT_H__
+#define __WORLDSNAPSHOT_H__
+
+#include "GameUtil.h"
+
+// A snapshot of a world as it was at the end of a tick, with a record for each
+// object in world index order
+struct SnapshotHeader
+{
+	uint magic;
+	unsigned short version;
+	// Size of each record, so readers can skip fields added by later versions
+	unsigned short record_size;
+	// Fixed ticks the world had completed
+	unsigned long long tick;
+	uint num_objects;
+	// Records that follow, fewer than the objects if the buffer was too small
+	uint num_records;
+};
+
+struct SnapshotRecord
+{
+	uint type_id;
+	float x;
+	float y;
+	float vx;
+	float vy;
+	float angle;
+	// Radius of the object's bounding sphere, or 0 if it has none
+	float radius;
+};
+
+// Snapshots are written as the packed little-endian fields of the header and
+// then of each record, in the order declared above
+const uint WORLD_SNAPSHOT_MAGIC = 0x50414E53; // "SNAP"
+const unsigned short WORLD_SNAPSHOT_VERSION = 1;
+const uint SNAPSHOT_HEADER_SIZE = 24;
+const uint SNAPSHOT_RECORD_SIZE = 28;
+
+uchar* WriteSnapshotHeader(uchar* buffer, const SnapshotHeader& header);
+uchar* WriteSnapshotRecord(uchar* buffer, const SnapshotRecord& record);
+bool ReadSnapshotHeader(const uchar* buffer, uint size, SnapshotHeader& header);
+void ReadSnapshotRecord(const uchar* buffer, const SnapshotHeader& header, uint i, SnapshotRecord& record);
+
+#endif